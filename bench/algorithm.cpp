@@ -0,0 +1,113 @@
+/// @author: ccat
+
+/// @brief: the algorithms of "expected_algorithm.hpp" on 1Mi-element arrays of `expected<int, int>` at failure rates
+/// from 0% to 50%, against the loop testing each element. build with `-mavx2` (or `-march=native`) for 32-byte scans
+
+#include "expected_algorithm.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using result = expected<int, int>;
+
+constexpr std::size_t array_size = 1 << 20;
+
+auto make_results(int percent) ->std::vector<result> {
+    std::vector<result> results;
+    results.reserve(array_size);
+    std::uint32_t state = 9;
+    for (std::size_t i = 0; i < array_size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        if (static_cast<int>(state % 1000) < percent * 10) results.emplace_back(unexpect, 1);
+        else results.emplace_back(static_cast<int>(i));
+    }
+    return results;
+}
+
+const bool registered = [] {
+    for (const int rate : {0, 1, 10, 50}) {
+        const auto suffix = "/failures:" + std::to_string(rate) + "%";
+        ccat_bench::add("count_failures/loop" + suffix, [results = make_results(rate)](std::uint64_t iterations) mutable {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat_bench::launder(results);
+                std::size_t n = 0;
+                for (const auto& x : results) n += !x.has_value();
+                ccat_bench::keep(n);
+            }
+        });
+        ccat_bench::add("count_failures/scan" + suffix, [results = make_results(rate)](std::uint64_t iterations) mutable {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat_bench::launder(results);
+                ccat_bench::keep(ccat::count_failures(results));
+            }
+        });
+        ccat_bench::add("partition_results/loop" + suffix, [results = make_results(rate)](std::uint64_t iterations) {
+            std::vector<int> values(array_size), errors(array_size);
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                auto v = values.data();
+                auto e = errors.data();
+                for (const auto& x : results) {
+                    if (x.has_value()) *v++ = *x;
+                    else *e++ = x.error();
+                }
+                ccat_bench::keep(v);
+                ccat_bench::keep(e);
+            }
+        });
+        ccat_bench::add("partition_results/scan" + suffix, [results = make_results(rate)](std::uint64_t iterations) {
+            std::vector<int> values(array_size), errors(array_size);
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto ends = ccat::partition_results(results.data(), results.data() + results.size(), values.data(), errors.data());
+                ccat_bench::keep(ends);
+            }
+        });
+        ccat_bench::add("transform_all/loop" + suffix, [results = make_results(rate)](std::uint64_t iterations) {
+            std::vector<expected<long, int>> out(array_size);
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                auto o = out.data();
+                for (const auto& x : results) *o++ = x.transform([](int v) { return long(v) * 3; });
+                ccat_bench::keep(o);
+            }
+        });
+        ccat_bench::add("transform_all/scan" + suffix, [results = make_results(rate)](std::uint64_t iterations) {
+            std::vector<expected<long, int>> out(array_size);
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto o = ccat::transform_all(results.data(), results.data() + results.size(), out.data(), [](int v) { return long(v) * 3; });
+                ccat_bench::keep(o);
+            }
+        });
+        ccat_bench::add("collect/loop" + suffix, [results = make_results(rate)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                std::vector<int> values;
+                values.reserve(results.size());
+                bool failed = false;
+                for (const auto& x : results) {
+                    if (!x.has_value()) {
+                        failed = true;
+                        break;
+                    }
+                    values.push_back(*x);
+                }
+                ccat_bench::keep(failed);
+                ccat_bench::keep(values.data());
+            }
+        });
+        ccat_bench::add("collect/scan" + suffix, [results = make_results(rate)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto collected = ccat::collect(results);
+                ccat_bench::keep(collected.has_value());
+            }
+        });
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
@@ -0,0 +1,120 @@
+#pragma once
+
+/// @author: ccat
+
+/// @brief: the minimal timing harness of the benchmarks. every case is a function running its loop `iterations` times,
+/// which the harness calls with more iterations until one run lasts `--min-time` seconds (default `0.2`),
+/// then prints every case as JSON to `stdout`. `--filter=<text>` only runs the cases whose name contains it
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ccat_bench {
+
+/// @brief: makes the optimizer assume `value` is read, so the computation of it can't be dropped
+template<typename T>
+inline auto keep(const T& value) noexcept ->void {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(*static_cast<const volatile char*>(static_cast<const void*>(&value)));
+#endif
+}
+
+/// @brief: makes the optimizer assume `value` may have changed, so it can't be folded into a constant
+template<typename T>
+inline auto launder(T& value) noexcept ->void {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    keep(value);
+#endif
+}
+
+struct bench_case {
+    std::string name;
+    std::function<void(std::uint64_t)> run;
+};
+
+inline auto registry() ->std::vector<bench_case>& {
+    static std::vector<bench_case> cases;
+    return cases;
+}
+
+/// @brief: registers a case, e.g. from the initializer of a namespace-scope variable
+inline auto add(std::string name, std::function<void(std::uint64_t)> run) ->bool {
+    registry().push_back({std::move(name), std::move(run)});
+    return true;
+}
+
+/// @brief: writes `s` as a JSON string
+inline auto print_string(const std::string& s) ->void {
+    std::putchar('"');
+    for (const char c : s) {
+        if (c == '"' || c == '\\') std::putchar('\\');
+        std::putchar(c);
+    }
+    std::putchar('"');
+}
+
+inline auto run(int argc, char** argv) ->int {
+    double min_time = 0.2;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--min-time=", 11) == 0) min_time = std::atof(argv[i] + 11);
+        else if (std::strncmp(argv[i], "--filter=", 9) == 0) filter = argv[i] + 9;
+        else {
+            std::fprintf(stderr, "usage: %s [--min-time=<seconds>] [--filter=<text>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::printf("{\n  \"context\": {\"cplusplus\": %ld, \"min_time\": %g},\n  \"benchmarks\": [", static_cast<long>(__cplusplus), min_time);
+    const char* separator = "\n";
+    for (const auto& c : registry()) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+        std::uint64_t iterations = 1;
+        double seconds = 0;
+        for (;;) {
+            const auto start = clock::now();
+            c.run(iterations);
+            seconds = std::chrono::duration<double>(clock::now() - start).count();
+            if (seconds >= min_time || iterations >= (std::uint64_t(1) << 40)) break;
+            const double scale = seconds > 0 ? 1.4 * min_time / seconds : 10;
+            iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * (scale < 10 ? (scale > 1.1 ? scale : 1.1) : 10)) + 1;
+        }
+        std::printf("%s    {\"name\": ", separator);
+        print_string(c.name);
+        std::printf(", \"iterations\": %llu, \"ns_per_iteration\": %.3f}", static_cast<unsigned long long>(iterations), seconds * 1e9 / static_cast<double>(iterations));
+        std::fflush(stdout);
+        separator = ",\n";
+    }
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
+
+}
+
+#define CCAT_BENCH_CONCAT_IMPL(a, b) a##b
+#define CCAT_BENCH_CONCAT(a, b) CCAT_BENCH_CONCAT_IMPL(a, b)
+
+/// @brief: defines a case, `CCAT_BENCH("name") { for (std::uint64_t i = 0; i < iterations; ++i) ...; }`
+#define CCAT_BENCH(name) \
+    static auto CCAT_BENCH_CONCAT(ccat_bench_case_, __LINE__)(std::uint64_t iterations) ->void; \
+    static const bool CCAT_BENCH_CONCAT(ccat_bench_registered_, __LINE__) = \
+        ::ccat_bench::add(name, &CCAT_BENCH_CONCAT(ccat_bench_case_, __LINE__)); \
+    static auto CCAT_BENCH_CONCAT(ccat_bench_case_, __LINE__)([[maybe_unused]] std::uint64_t iterations) ->void
+
+/// @brief: the `main` of a benchmark executable
+#define CCAT_BENCH_MAIN() \
+    auto main(int argc, char** argv) ->int { \
+        return ::ccat_bench::run(argc, argv); \
+    }
@@ -0,0 +1,76 @@
+/// @author: ccat
+
+/// @brief: `expected_cache` looked up from 1 to 8 threads at hit rates from 50% to 99%, next to calling the function
+/// it caches directly. hits go to a warm set of keys, misses to keys never seen before, and a third of the keys fail
+
+#include "expected_cache.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using result = expected<std::uint64_t, int>;
+
+constexpr std::uint64_t warm_keys = 1024;
+
+/// @brief: the cached function, about a microsecond of work standing in for a lookup
+[[gnu::noinline]] auto compute(const std::uint64_t& key) ->result {
+    std::uint64_t x = key;
+    for (int i = 0; i < 512; ++i) x = x * 6364136223846793005u + 1442695040888963407u;
+    if (key % 3 == 0) return result(unexpect, static_cast<int>(x >> 60));
+    return x;
+}
+
+/// @brief: the key of the `i`-th lookup of `thread`, one of the warm keys `percent`% of the time
+auto key_of(std::uint64_t i, std::uint64_t thread, int percent) ->std::uint64_t {
+    const auto mixed = (i + 1) * 0x9e3779b97f4a7c15u;
+    if (static_cast<int>(mixed >> 57) % 100 < percent) return mixed >> 20 & (warm_keys - 1);
+    return warm_keys + (thread << 40 | i);
+}
+
+/// @brief: splits `iterations` over `threads` threads, each running `lookup(i, thread)`
+template<typename Lookup>
+auto run_threads(std::uint64_t iterations, std::uint64_t threads, Lookup lookup) ->void {
+    std::vector<std::thread> workers;
+    for (std::uint64_t t = 0; t < threads; ++t) {
+        workers.emplace_back([=] {
+            std::uint64_t sum = 0;
+            for (std::uint64_t i = t; i < iterations; i += threads) sum += lookup(i, t);
+            ccat_bench::keep(sum);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+const bool registered = [] {
+    for (const std::uint64_t threads : {1, 4, 8}) {
+        for (const int rate : {50, 90, 99}) {
+            const auto suffix = "/threads:" + std::to_string(threads) + "/hits:" + std::to_string(rate) + "%";
+            ccat_bench::add("lookup/direct" + suffix, [=](std::uint64_t iterations) {
+                run_threads(iterations, threads, [rate](std::uint64_t i, std::uint64_t t) {
+                    const auto r = compute(key_of(i, t, rate));
+                    return r.has_value() ? *r : static_cast<std::uint64_t>(r.error());
+                });
+            });
+            ccat_bench::add("lookup/cache" + suffix, [=](std::uint64_t iterations) {
+                ccat::expected_cache<std::uint64_t, std::uint64_t, int> cache(ccat::cache_options{4 * warm_keys});
+                for (std::uint64_t k = 0; k < warm_keys; ++k) cache.get_or_compute(k, compute);
+                run_threads(iterations, threads, [rate, &cache](std::uint64_t i, std::uint64_t t) {
+                    const auto r = cache.get_or_compute(key_of(i, t, rate), compute);
+                    return r.has_value() ? *r : static_cast<std::uint64_t>(r.error());
+                });
+            });
+        }
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
@@ -0,0 +1,60 @@
+# the compile-time cost of `expected`: generates a translation unit with `COUNT` functions over distinct
+# `expected<value<I>, error<I>>`s, each using the members every `expected` has, and compiles it with the header, with `CCAT_EXPECTED_LEAN`,
+# and with `std::expected` where `STANDARD` has it. prints the compile time and the object size of each as JSON:
+# `cmake -D COMPILER=<c++> -D INCLUDE=<dir> -D WORK_DIR=<dir> [-D STANDARD=<17|20|23>] [-D COUNT=<n>] -P compile_time.cmake`
+if(NOT DEFINED COUNT)
+    set(COUNT 200)
+endif()
+if(NOT DEFINED STANDARD)
+    set(STANDARD 17)
+endif()
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+function(generate file header ns)
+    set(source "#include ${header}\n\ntemplate<int I> struct value { int v; };\ntemplate<int I> struct error { int code; };\n\n")
+    math(EXPR last "${COUNT} - 1")
+    foreach(i RANGE ${last})
+        string(APPEND source
+            "auto parse${i}(int x) ->${ns}::expected<value<${i}>, error<${i}>> {\n"
+            "    if (x < 0) return ${ns}::unexpected(error<${i}>{x});\n"
+            "    return value<${i}>{x};\n"
+            "}\n"
+            "auto use${i}(int x) ->int {\n"
+            "    const auto r = parse${i}(x);\n"
+            "    if (!r.has_value()) return r.error().code;\n"
+            "    const auto s = parse${i}(r->v - 1);\n"
+            "    return s.value_or(value<${i}>{r->v * 2}).v;\n"
+            "}\n")
+    endforeach()
+    file(WRITE ${file} "${source}")
+endfunction()
+
+function(measure name file)
+    set(object ${WORK_DIR}/${name}.o)
+    string(TIMESTAMP start "%s%f")
+    execute_process(
+        COMMAND ${COMPILER} -std=c++${STANDARD} -O2 -I${INCLUDE} ${ARGN} -c ${file} -o ${object}
+        RESULT_VARIABLE status
+        ERROR_VARIABLE diagnostics
+    )
+    string(TIMESTAMP stop "%s%f")
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "compiling ${file} failed:\n${diagnostics}")
+    endif()
+    math(EXPR micros "${stop} - ${start}")
+    math(EXPR millis "${micros} / 1000")
+    file(SIZE ${object} bytes)
+    set(results "${results}    {\"name\": \"compile/${name}/instantiations:${COUNT}\", \"milliseconds\": ${millis}, \"object_bytes\": ${bytes}},\n" PARENT_SCOPE)
+endfunction()
+
+set(results "")
+generate(${WORK_DIR}/ccat.cpp "\"expected.hpp\"" ccat)
+measure(ccat ${WORK_DIR}/ccat.cpp)
+measure(ccat_lean ${WORK_DIR}/ccat.cpp -DCCAT_EXPECTED_LEAN)
+if(STANDARD GREATER_EQUAL 23)
+    generate(${WORK_DIR}/std.cpp "<expected>" std)
+    measure(std ${WORK_DIR}/std.cpp)
+endif()
+
+string(REGEX REPLACE ",\n$" "\n" results "${results}")
+message("{\n  \"context\": {\"standard\": ${STANDARD}, \"count\": ${COUNT}},\n  \"benchmarks\": [\n${results}  ]\n}")
@@ -0,0 +1,112 @@
+/// @author: ccat
+
+/// @brief: a four-layer call chain attaching context to its error at every layer, with `context_error` and by
+/// concatenating `std::string`s, next to the bare error. one iteration is one call out of a million a second, so
+/// failing 1, 10 or 100 calls in a thousand is 1k, 10k or 100k failures a second. every failed call is logged
+/// (the chain formatted) one time in a hundred
+
+#include "expected_context.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using ccat::context;
+using ccat::context_error;
+using ccat::expected;
+using ccat::unexpect;
+
+/// @brief: whether the `i`-th call fails, `per_thousand` calls in a thousand
+auto fails(std::uint64_t i, int per_thousand) ->bool {
+    return static_cast<int>((i + 1) * 0x9e3779b97f4a7c15u >> 54) % 1000 < per_thousand;
+}
+
+[[gnu::noinline]] auto bare_read(std::uint64_t i, int rate) ->expected<std::uint64_t, int> {
+    if (fails(i, rate)) return expected<std::uint64_t, int>(unexpect, 5);
+    return i;
+}
+[[gnu::noinline]] auto bare_parse(std::uint64_t i, int rate) ->expected<std::uint64_t, int> {
+    return bare_read(i, rate).transform([](std::uint64_t x) { return x * 3; });
+}
+[[gnu::noinline]] auto bare_load(std::uint64_t i, int rate) ->expected<std::uint64_t, int> {
+    return bare_parse(i, rate).transform([](std::uint64_t x) { return x + 1; });
+}
+[[gnu::noinline]] auto bare_serve(std::uint64_t i, int rate) ->expected<std::uint64_t, int> {
+    return bare_load(i, rate).transform([](std::uint64_t x) { return x ^ 7; });
+}
+
+using with_context = expected<std::uint64_t, context_error<int>>;
+
+[[gnu::noinline]] auto context_read(std::uint64_t i, int rate) ->with_context {
+    if (fails(i, rate)) return expected<std::uint64_t, int>(unexpect, 5).transform_error(context("reading the header"));
+    return i;
+}
+[[gnu::noinline]] auto context_parse(std::uint64_t i, int rate) ->with_context {
+    return context_read(i, rate).transform([](std::uint64_t x) { return x * 3; }).transform_error(context("parsing the record"));
+}
+[[gnu::noinline]] auto context_load(std::uint64_t i, int rate) ->with_context {
+    return context_parse(i, rate).transform([](std::uint64_t x) { return x + 1; }).transform_error(context("loading the table"));
+}
+[[gnu::noinline]] auto context_serve(std::uint64_t i, int rate) ->with_context {
+    return context_load(i, rate).transform([](std::uint64_t x) { return x ^ 7; }).transform_error(context("serving the request"));
+}
+
+using with_string = expected<std::uint64_t, std::string>;
+
+[[gnu::noinline]] auto string_read(std::uint64_t i, int rate) ->with_string {
+    if (fails(i, rate)) return with_string(unexpect, "error 5 (" __FILE__ ":" + std::to_string(__LINE__) + ")");
+    return i;
+}
+[[gnu::noinline]] auto string_parse(std::uint64_t i, int rate) ->with_string {
+    return string_read(i, rate).transform([](std::uint64_t x) { return x * 3; }).transform_error([](std::string e) {
+        return "parsing the record (" __FILE__ ":" + std::to_string(__LINE__) + "): " + e;
+    });
+}
+[[gnu::noinline]] auto string_load(std::uint64_t i, int rate) ->with_string {
+    return string_parse(i, rate).transform([](std::uint64_t x) { return x + 1; }).transform_error([](std::string e) {
+        return "loading the table (" __FILE__ ":" + std::to_string(__LINE__) + "): " + e;
+    });
+}
+[[gnu::noinline]] auto string_serve(std::uint64_t i, int rate) ->with_string {
+    return string_load(i, rate).transform([](std::uint64_t x) { return x ^ 7; }).transform_error([](std::string e) {
+        return "serving the request (" __FILE__ ":" + std::to_string(__LINE__) + "): " + e;
+    });
+}
+
+const bool registered = [] {
+    for (const int rate : {1, 10, 100}) {
+        const auto suffix = "/failures:" + std::to_string(rate) + "k/s";
+        ccat_bench::add("chain/bare" + suffix, [rate](std::uint64_t iterations) {
+            std::uint64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = bare_serve(i, rate);
+                sum += r.has_value() ? *r : static_cast<std::uint64_t>(r.error());
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("chain/context_error" + suffix, [rate](std::uint64_t iterations) {
+            std::uint64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = context_serve(i, rate);
+                if (r.has_value()) sum += *r;
+                else if (i % 100 == 0) sum += r.error().describe().size();
+                else sum += r.error().depth();
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("chain/string" + suffix, [rate](std::uint64_t iterations) {
+            std::uint64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = string_serve(i, rate);
+                sum += r.has_value() ? *r : r.error().size();
+            }
+            ccat_bench::keep(sum);
+        });
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
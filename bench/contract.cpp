@@ -0,0 +1,62 @@
+/// @author: ccat
+
+/// @brief: summing `*x` and `x.error()` over a vector of `expected`, built once per `CCAT_EXPECTED_CONTRACT` mode.
+/// the checks of the trap and diagnose modes are the difference to the assume mode
+
+#include "expected.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+#if CCAT_EXPECTED_CONTRACT == CCAT_EXPECTED_CONTRACT_ASSUME
+constexpr const char* mode = "assume";
+#elif CCAT_EXPECTED_CONTRACT == CCAT_EXPECTED_CONTRACT_TRAP
+constexpr const char* mode = "trap";
+#else
+constexpr const char* mode = "diagnose";
+#endif
+
+using result = expected<int, long>;
+
+auto make_values() ->std::vector<result> {
+    std::vector<result> xs;
+    for (int i = 0; i < 4096; ++i) xs.emplace_back(i * 7 % 1000);
+    return xs;
+}
+
+auto make_errors() ->std::vector<result> {
+    std::vector<result> xs;
+    for (int i = 0; i < 4096; ++i) xs.emplace_back(unexpect, i * 7 % 1000);
+    return xs;
+}
+
+const bool registered = [] {
+    const std::string suffix = std::string("/contract:") + mode;
+    ccat_bench::add("sum/value" + suffix, [xs = make_values()](std::uint64_t iterations) mutable {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            ccat_bench::launder(xs);
+            std::int64_t sum = 0;
+            for (const auto& x : xs) sum += *x;
+            ccat_bench::keep(sum);
+        }
+    });
+    ccat_bench::add("sum/error" + suffix, [xs = make_errors()](std::uint64_t iterations) mutable {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            ccat_bench::launder(xs);
+            std::int64_t sum = 0;
+            for (const auto& x : xs) sum += x.error();
+            ccat_bench::keep(sum);
+        }
+    });
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
@@ -0,0 +1,220 @@
+/// @author: ccat
+
+/// @brief: the cost of the core operations of `expected`: construction, copy and move, returning through a call
+/// that isn't inlined at failure rates from 0% to 100%, `and_then`/`transform` chains 1 to 10 deep, and the same
+/// computations with exceptions and, when the standard library has it, `std::expected`
+
+#include "expected.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__has_include)
+#if __has_include(<expected>) && __cplusplus > 202002L
+#include <expected>
+#endif
+#endif
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+using ccat::unexpected;
+
+enum class errc : int { none, invalid, range };
+
+constexpr int failure_rates[] = {0, 1, 10, 50, 90, 100};
+
+/// @brief: `n` inputs of which `percent`% are negative, spread evenly so the branch predictor sees the given rate
+auto make_inputs(int percent) ->std::vector<int> {
+    std::vector<int> inputs(1024);
+    std::uint32_t state = 12345;
+    for (auto& x : inputs) {
+        state = state * 1664525u + 1013904223u;
+        const auto value = static_cast<int>(state >> 8 & 0xffff);
+        x = static_cast<int>(state % 100) < percent ? -value - 1 : value;
+    }
+    return inputs;
+}
+
+[[gnu::noinline]] auto parse(int x) ->expected<std::int64_t, errc> {
+    if (x < 0) return unexpected(errc::invalid);
+    return std::int64_t(x) * 3;
+}
+
+[[gnu::noinline]] auto parse_or_throw(int x) ->std::int64_t {
+    if (x < 0) throw std::invalid_argument("negative");
+    return std::int64_t(x) * 3;
+}
+
+[[gnu::noinline]] auto parse_string(int x) ->expected<std::string, std::string> {
+    if (x < 0) return unexpected(std::string("negative input, which no parser accepts"));
+    return std::string("a value long enough not to fit inline");
+}
+
+#if defined(__cpp_lib_expected)
+[[gnu::noinline]] auto parse_std(int x) ->std::expected<std::int64_t, errc> {
+    if (x < 0) return std::unexpected(errc::invalid);
+    return std::int64_t(x) * 3;
+}
+#endif
+
+const bool registered_rates = [] {
+    for (const int rate : failure_rates) {
+        const auto suffix = "/failures:" + std::to_string(rate) + "%";
+        ccat_bench::add("return/expected" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = parse(inputs[i % inputs.size()]);
+                if (r.has_value()) sum += *r;
+                else ++sum;
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("return/exception" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                try {
+                    sum += parse_or_throw(inputs[i % inputs.size()]);
+                }
+                catch (const std::invalid_argument&) {
+                    ++sum;
+                }
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("value/throwing" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                try {
+                    sum += parse(inputs[i % inputs.size()]).value();
+                }
+                catch (const ccat::bad_expected_access<errc>&) {
+                    ++sum;
+                }
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("return/expected_string" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::size_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = parse_string(inputs[i % inputs.size()]);
+                sum += r.has_value() ? r->size() : r.error().size();
+            }
+            ccat_bench::keep(sum);
+        });
+#if defined(__cpp_lib_expected)
+        ccat_bench::add("return/std_expected" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = parse_std(inputs[i % inputs.size()]);
+                if (r.has_value()) sum += *r;
+                else ++sum;
+            }
+            ccat_bench::keep(sum);
+        });
+#endif
+    }
+    return true;
+}();
+
+CCAT_BENCH("construct/value") {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        expected<std::int64_t, errc> x(static_cast<std::int64_t>(i));
+        ccat_bench::keep(x);
+    }
+}
+
+CCAT_BENCH("construct/error") {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        expected<std::int64_t, errc> x(unexpect, errc::range);
+        ccat_bench::keep(x);
+    }
+}
+
+CCAT_BENCH("construct/string_value") {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        expected<std::string, std::string> x(std::in_place, 40, 'v');
+        ccat_bench::keep(x);
+    }
+}
+
+CCAT_BENCH("copy/string_value") {
+    const expected<std::string, std::string> source(std::in_place, 40, 'v');
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto x = source;
+        ccat_bench::keep(x);
+    }
+}
+
+CCAT_BENCH("copy/string_error") {
+    const expected<std::string, std::string> source(unexpect, 40, 'e');
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto x = source;
+        ccat_bench::keep(x);
+    }
+}
+
+CCAT_BENCH("move/string_value") {
+    expected<std::string, std::string> a(std::in_place, 40, 'v');
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto b = std::move(a);
+        a = std::move(b);
+        ccat_bench::keep(a);
+    }
+}
+
+CCAT_BENCH("move/int_value") {
+    expected<std::int64_t, errc> a(1);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        ccat_bench::launder(a);
+        auto b = std::move(a);
+        ccat_bench::keep(b);
+    }
+}
+
+template<int Depth, typename X>
+auto and_then_chain(X&& x) {
+    if constexpr (Depth == 0)
+        return std::forward<X>(x);
+    else
+        return and_then_chain<Depth - 1>(std::forward<X>(x).and_then([](std::int64_t v) -> expected<std::int64_t, errc> {
+            if (v < 0) return unexpected(errc::range);
+            return v + 1;
+        }));
+}
+
+template<int Depth, typename X>
+auto transform_chain(X&& x) {
+    if constexpr (Depth == 0)
+        return std::forward<X>(x);
+    else
+        return transform_chain<Depth - 1>(std::forward<X>(x).transform([](std::int64_t v) { return v * 3 + 1; }));
+}
+
+template<int Depth>
+auto add_chains() ->void {
+    if constexpr (Depth > 0) {
+        add_chains<Depth - 1>();
+        for (const int rate : {0, 50}) {
+            const auto name = std::to_string(Depth) + "/failures:" + std::to_string(rate) + "%";
+            ccat_bench::add("and_then/depth:" + name, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+                std::int64_t sum = 0;
+                for (std::uint64_t i = 0; i < iterations; ++i) sum += and_then_chain<Depth>(parse(inputs[i % inputs.size()])).value_or(1);
+                ccat_bench::keep(sum);
+            });
+            ccat_bench::add("transform/depth:" + name, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+                std::int64_t sum = 0;
+                for (std::uint64_t i = 0; i < iterations; ++i) sum += transform_chain<Depth>(parse(inputs[i % inputs.size()])).value_or(1);
+                ccat_bench::keep(sum);
+            });
+        }
+    }
+}
+
+const bool registered_chains = (add_chains<10>(), true);
+
+}
+
+CCAT_BENCH_MAIN()
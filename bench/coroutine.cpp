@@ -0,0 +1,88 @@
+/// @author: ccat
+
+/// @brief: a three-step chain written as a coroutine returning `expected` and by hand with early returns,
+/// failing at rates from 0% to 100%. the coroutine pays for its frame, taken from the thread's arena
+
+#include "expected_coroutine.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(CCAT_EXPECTED_HAS_COROUTINE)
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using result = expected<std::int64_t, int>;
+
+auto make_inputs(int percent) ->std::vector<int> {
+    std::vector<int> inputs(1024);
+    std::uint32_t state = 2024;
+    for (auto& x : inputs) {
+        state = state * 1664525u + 1013904223u;
+        x = static_cast<int>(state % 100) < percent ? -1 - static_cast<int>(state >> 28) : static_cast<int>(state >> 8 & 0xfff);
+    }
+    return inputs;
+}
+
+/// @brief: negative inputs fail here, half of them, and the rest at `parse`
+[[gnu::noinline]] auto read(int x) ->result {
+    if (x < 0 && x % 2 != 0) return result(unexpect, x);
+    return x;
+}
+[[gnu::noinline]] auto parse(std::int64_t x) ->result {
+    if (x < 0) return result(unexpect, 7);
+    return x * 3;
+}
+[[gnu::noinline]] auto check(std::int64_t x) ->result {
+    return x ^ 5;
+}
+
+[[gnu::noinline]] auto early_return(int x) ->result {
+    auto a = read(x);
+    if (!a) return result(unexpect, a.error());
+    auto b = parse(*a);
+    if (!b) return result(unexpect, b.error());
+    auto c = check(*b);
+    if (!c) return result(unexpect, c.error());
+    return *c + 1;
+}
+
+[[gnu::noinline]] auto coroutine(int x) ->result {
+    const auto a = co_await read(x);
+    const auto b = co_await parse(a);
+    const auto c = co_await check(b);
+    co_return c + 1;
+}
+
+const bool registered = [] {
+    for (const int rate : {0, 10, 50, 100}) {
+        const auto suffix = "/failures:" + std::to_string(rate) + "%";
+        ccat_bench::add("chain/early_return" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = early_return(inputs[i % inputs.size()]);
+                sum += r.has_value() ? *r : r.error();
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("chain/coroutine" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = coroutine(inputs[i % inputs.size()]);
+                sum += r.has_value() ? *r : r.error();
+            }
+            ccat_bench::keep(sum);
+        });
+    }
+    return true;
+}();
+
+}
+
+#endif
+
+CCAT_BENCH_MAIN()
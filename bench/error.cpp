@@ -0,0 +1,81 @@
+/// @author: ccat
+
+/// @brief: a three-layer call chain failing one call in eight, with `ccat::error`, `std::string` and `std::error_code`
+/// as its error type: what a failure costs to make, to propagate, and to turn into a message
+
+#include "expected_error.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+auto fails(std::uint64_t i) ->bool {
+    return ((i + 1) * 0x9e3779b97f4a7c15u >> 60) < 2;
+}
+
+/// @brief: what each error type is built from at the source of a failure
+template<typename E>
+auto make_error() ->E {
+    if constexpr (std::is_same_v<E, std::string>)
+        return "connection reset by peer";
+    else
+        return std::make_error_code(std::errc::connection_reset);
+}
+
+template<typename E>
+[[gnu::noinline]] auto read(std::uint64_t i) ->expected<std::uint64_t, E> {
+    if (fails(i)) return expected<std::uint64_t, E>(unexpect, make_error<E>());
+    return i;
+}
+template<typename E>
+[[gnu::noinline]] auto parse(std::uint64_t i) ->expected<std::uint64_t, E> {
+    return read<E>(i).transform([](std::uint64_t x) { return x * 3; });
+}
+template<typename E>
+[[gnu::noinline]] auto serve(std::uint64_t i) ->expected<std::uint64_t, E> {
+    return parse<E>(i).transform([](std::uint64_t x) { return x + 1; });
+}
+
+template<typename E>
+auto message_of(const E& e) ->std::string {
+    if constexpr (std::is_same_v<E, std::string>)
+        return e;
+    else
+        return e.message();
+}
+
+template<typename E>
+auto add(const std::string& name) ->void {
+    ccat_bench::add("chain/" + name, [](std::uint64_t iterations) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            const auto r = serve<E>(i);
+            sum += r.has_value() ? *r : 1;
+        }
+        ccat_bench::keep(sum);
+    });
+    ccat_bench::add("chain_and_message/" + name, [](std::uint64_t iterations) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            const auto r = serve<E>(i);
+            sum += r.has_value() ? *r : message_of(r.error()).size();
+        }
+        ccat_bench::keep(sum);
+    });
+}
+
+const bool registered = [] {
+    add<ccat::error>("ccat::error");
+    add<std::string>("std::string");
+    add<std::error_code>("std::error_code");
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
@@ -0,0 +1,49 @@
+/// @author: ccat
+
+/// @brief: a two-layer call chain making its errors with `unexpected(e)`, failing 0% to 100% of the time.
+/// built with and without `CCAT_EXPECTED_INSTRUMENT`, the difference is what counting every failure site costs
+
+#include "expected.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpected;
+
+using result = expected<std::uint64_t, int>;
+
+auto fails(std::uint64_t i, int percent) ->bool {
+    return static_cast<int>((i + 1) * 0x9e3779b97f4a7c15u >> 57) % 100 < percent;
+}
+
+[[gnu::noinline]] auto read(std::uint64_t i, int percent) ->result {
+    if (fails(i, percent)) return unexpected(static_cast<int>(i & 0xff));
+    return i;
+}
+
+[[gnu::noinline]] auto parse(std::uint64_t i, int percent) ->result {
+    const auto r = read(i, percent);
+    if (!r.has_value()) return unexpected(r.error() + 1);
+    return *r * 3;
+}
+
+const bool registered = [] {
+    for (const int rate : {0, 1, 10, 100}) {
+        ccat_bench::add("chain/failures:" + std::to_string(rate) + "%", [rate](std::uint64_t iterations) {
+            std::uint64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = parse(i, rate);
+                sum += r.has_value() ? *r : static_cast<std::uint64_t>(r.error());
+            }
+            ccat_bench::keep(sum);
+        });
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
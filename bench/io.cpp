@@ -0,0 +1,108 @@
+/// @author: ccat
+
+/// @brief: reading a 4 MiB file (in the page cache) with the io helpers, next to the plain `pread` loops one would write
+/// instead: whole, in 64 KiB chunks, and as a batch of 4 KiB requests that follow each other or are scattered over
+/// the file. one iteration reads the whole file, or half of it for the scattered batch
+
+#include "expected_io.hpp"
+#include "bench.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using ccat::read_request;
+
+constexpr std::size_t file_size = 4 << 20;
+constexpr std::size_t chunk = 64 << 10;
+constexpr std::size_t block = 4 << 10;
+
+auto make_file() ->int {
+    char path[] = "/tmp/ccat_expected_bench_io_XXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd < 0) std::abort();
+    ::unlink(path);
+    const std::string content(file_size, 'x');
+    if (!ccat::write_full(fd, content.data(), content.size())) std::abort();
+    return fd;
+}
+
+/// @brief: `pread` until `size` bytes are read, as one would write it without the helpers
+[[gnu::noinline]] auto plain_pread(int fd, char* buffer, std::size_t size, ::off_t offset) ->std::size_t {
+    std::size_t done = 0;
+    while (done < size) {
+        const auto n = ::pread(fd, buffer + done, size - done, offset + static_cast<::off_t>(done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        if (n == 0) break;
+        done += static_cast<std::size_t>(n);
+    }
+    return done;
+}
+
+/// @brief: requests of `block` bytes with `stride` bytes from the start of one to the next
+auto make_requests(int fd, std::vector<char>& buffer, std::size_t stride) ->std::vector<read_request> {
+    std::vector<read_request> requests;
+    for (std::size_t at = 0, i = 0; at + block <= file_size; at += stride, ++i)
+        requests.push_back(read_request{fd, buffer.data() + i * block, block, static_cast<::off_t>(at)});
+    return requests;
+}
+
+const bool registered = [] {
+    static const int fd = make_file();
+    static std::vector<char> buffer(file_size);
+
+    ccat_bench::add("whole/plain_pread", [](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) ccat_bench::keep(plain_pread(fd, buffer.data(), file_size, 0));
+    });
+    ccat_bench::add("whole/pread_full", [](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) ccat_bench::keep(ccat::pread_full(fd, buffer.data(), file_size, 0).value());
+    });
+    ccat_bench::add("chunks/plain_pread", [](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            std::size_t sum = 0;
+            for (std::size_t at = 0; at < file_size; at += chunk) sum += plain_pread(fd, buffer.data() + at, chunk, static_cast<::off_t>(at));
+            ccat_bench::keep(sum);
+        }
+    });
+    ccat_bench::add("chunks/pread_full", [](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            std::size_t sum = 0;
+            for (std::size_t at = 0; at < file_size; at += chunk) sum += ccat::pread_full(fd, buffer.data() + at, chunk, static_cast<::off_t>(at)).value();
+            ccat_bench::keep(sum);
+        }
+    });
+
+    const std::pair<const char*, std::size_t> layouts[] = {{"adjacent", block}, {"scattered", 2 * block}};
+    for (const auto& [layout, stride] : layouts) {
+        const auto requests = make_requests(fd, buffer, stride);
+        ccat_bench::add(std::string("batch/plain_pread/") + layout, [requests](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                std::size_t sum = 0;
+                for (const auto& r : requests) sum += plain_pread(r.fd, static_cast<char*>(r.buffer), r.size, r.offset);
+                ccat_bench::keep(sum);
+            }
+        });
+        ccat_bench::add(std::string("batch/read_batch/") + layout, [requests](std::uint64_t iterations) {
+            std::vector<ccat::expected<std::size_t, std::error_code>> results;
+            results.reserve(requests.size());
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                results.clear();
+                ccat::read_batch(requests.data(), requests.size(), std::back_inserter(results));
+                ccat_bench::keep(results.back());
+            }
+        });
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
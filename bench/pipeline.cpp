@@ -0,0 +1,91 @@
+/// @author: ccat
+
+/// @brief: a six-step parser chain with a large error type, written with the eager members and with `ccat::pipe`,
+/// failing at the source or midway at rates from 0% to 100%
+
+#include "expected.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+struct parse_error {
+    std::string message;
+    std::string context;
+    int code;
+};
+
+using result = expected<std::int64_t, parse_error>;
+
+auto make_inputs(int percent) ->std::vector<int> {
+    std::vector<int> inputs(1024);
+    std::uint32_t state = 2024;
+    for (auto& x : inputs) {
+        state = state * 1664525u + 1013904223u;
+        x = static_cast<int>(state % 100) < percent ? -1 - static_cast<int>(state >> 28) : static_cast<int>(state >> 8 & 0xfff);
+    }
+    return inputs;
+}
+
+/// @brief: negative inputs fail at the source, half of them, and the rest at the fourth step
+[[gnu::noinline]] auto read(int x) ->result {
+    if (x < 0 && x % 2 != 0) return result(unexpect, parse_error{"unexpected end of input while reading", "at line 42 of config.toml", x});
+    return x;
+}
+
+constexpr auto lex = [](std::int64_t x) ->result {
+    return x + 1;
+};
+constexpr auto trim = [](std::int64_t x) {
+    return x * 2;
+};
+constexpr auto parse = [](std::int64_t x) ->result {
+    if (x < 0) return result(unexpect, parse_error{"expected an identifier after `let`", "in the body of `main`", 7});
+    return x - 3;
+};
+constexpr auto check = [](std::int64_t x) ->result {
+    return x ^ 5;
+};
+constexpr auto lower = [](std::int64_t x) {
+    return x + 11;
+};
+
+[[gnu::noinline]] auto eager(int x) ->result {
+    return read(x).and_then(lex).transform(trim).and_then(parse).and_then(check).transform(lower);
+}
+
+[[gnu::noinline]] auto piped(int x) ->result {
+    return ccat::pipe(read(x)) | ccat::then(lex) | ccat::map(trim) | ccat::then(parse) | ccat::then(check) | ccat::map(lower);
+}
+
+const bool registered = [] {
+    for (const int rate : {0, 10, 50, 100}) {
+        const auto suffix = "/failures:" + std::to_string(rate) + "%";
+        ccat_bench::add("chain/eager" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = eager(inputs[i % inputs.size()]);
+                sum += r.has_value() ? *r : r.error().code;
+            }
+            ccat_bench::keep(sum);
+        });
+        ccat_bench::add("chain/pipe" + suffix, [inputs = make_inputs(rate)](std::uint64_t iterations) {
+            std::int64_t sum = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                const auto r = piped(inputs[i % inputs.size()]);
+                sum += r.has_value() ? *r : r.error().code;
+            }
+            ccat_bench::keep(sum);
+        });
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
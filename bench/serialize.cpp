@@ -0,0 +1,81 @@
+/// @author: ccat
+
+/// @brief: 4096 `expected<std::uint64_t, std::uint32_t>`, one in eight failed, written with `serialize_all` and
+/// with the loop one would write by hand for the same bytes, then read back with `expected_array_view`
+
+#include "expected_serialize.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using record = expected<std::uint64_t, std::uint32_t>;
+using layout = ccat::wire_layout<std::uint64_t, std::uint32_t>;
+
+auto make_records() ->std::vector<record> {
+    std::vector<record> records;
+    for (std::uint32_t i = 0; i < 4096; ++i) {
+        if (i % 8 == 5) records.emplace_back(unexpect, i);
+        else records.emplace_back(std::uint64_t{i} * 0x9e3779b97f4a7c15u);
+    }
+    return records;
+}
+
+/// @brief: the same bytes as `serialize_all`: a tag, the payload at offset 8, zeros elsewhere
+[[gnu::noinline]] auto write_by_hand(const std::vector<record>& records, std::byte* out) ->void {
+    for (const auto& x : records) {
+        std::memset(out, 0, layout::size);
+        if (x.has_value()) {
+            out[0] = static_cast<std::byte>(layout::value_tag);
+            std::memcpy(out + 8, &*x, sizeof(std::uint64_t));
+        }
+        else {
+            out[0] = static_cast<std::byte>(layout::error_tag);
+            std::memcpy(out + 8, &x.error(), sizeof(std::uint32_t));
+        }
+        out += layout::size;
+    }
+}
+
+[[gnu::noinline]] auto write_serialize_all(const std::vector<record>& records, std::byte* out) ->void {
+    ccat_bench::keep(ccat::serialize_all(records.begin(), records.end(), out, records.size() * layout::size));
+}
+
+const bool registered = [] {
+    static const auto records = make_records();
+    static std::vector<std::byte> bytes(records.size() * layout::size);
+    ccat_bench::add("write/by_hand", [](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            write_by_hand(records, bytes.data());
+            ccat_bench::keep(bytes[0]);
+        }
+    });
+    ccat_bench::add("write/serialize_all", [](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            write_serialize_all(records, bytes.data());
+            ccat_bench::keep(bytes[0]);
+        }
+    });
+    ccat_bench::add("read/expected_array_view", [](std::uint64_t iterations) {
+        write_serialize_all(records, bytes.data());
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            const auto view = ccat::expected_array_view<std::uint64_t, std::uint32_t>::from(bytes.data(), bytes.size());
+            std::uint64_t sum = 0;
+            for (std::size_t k = 0; k < view->size(); ++k) {
+                const auto x = (*view)[k];
+                sum += x.has_value() ? *x : x.error();
+            }
+            ccat_bench::keep(sum);
+        }
+    });
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
@@ -0,0 +1,75 @@
+/// @author: ccat
+
+/// @brief: `validate` over 5, 20 and 100 `expected<int, int>` fields with none, one or every tenth of them failed,
+/// next to the loop one would write by hand, collecting the values into an array and the errors into a `std::vector`.
+/// one iteration is one whole validation
+
+#include "expected_validate.hpp"
+#include "bench.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using field = expected<int, int>;
+
+template<std::size_t F>
+auto make_fields(std::size_t period) ->std::array<field, F> {
+    std::array<field, F> fields;
+    for (std::size_t i = 0; i < F; ++i) {
+        if (period && i % period == period - 1) fields[i] = field(unexpect, static_cast<int>(i));
+        else fields[i] = static_cast<int>(i * 7);
+    }
+    return fields;
+}
+
+template<std::size_t F, std::size_t... I>
+[[gnu::noinline]] auto with_validate(const std::array<field, F>& fields, std::index_sequence<I...>) ->std::uint64_t {
+    const auto r = ccat::validate(fields[I]...);
+    if (r.has_value()) return static_cast<std::uint64_t>(std::get<F - 1>(*r));
+    return r.error().size();
+}
+
+template<std::size_t F>
+[[gnu::noinline]] auto by_hand(const std::array<field, F>& fields) ->std::uint64_t {
+    std::array<int, F> values;
+    std::vector<int> errors;
+    for (std::size_t i = 0; i < F; ++i) {
+        if (fields[i].has_value()) values[i] = *fields[i];
+        else errors.push_back(fields[i].error());
+    }
+    if (errors.empty()) return static_cast<std::uint64_t>(values[F - 1]);
+    return errors.size();
+}
+
+template<std::size_t F>
+auto add() ->void {
+    /// @note: a period of zero fails no field, one of `F` only the last
+    const std::pair<const char*, std::size_t> failures[] = {{"none", 0}, {"one", F}, {"tenth", 10}};
+    for (const auto& [failure, period] : failures) {
+        const auto suffix = "/fields:" + std::to_string(F) + "/failure:" + failure;
+        ccat_bench::add("validate" + suffix, [fields = make_fields<F>(period)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) ccat_bench::keep(with_validate(fields, std::make_index_sequence<F>{}));
+        });
+        ccat_bench::add("by_hand" + suffix, [fields = make_fields<F>(period)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) ccat_bench::keep(by_hand(fields));
+        });
+    }
+}
+
+const bool registered = [] {
+    add<5>();
+    add<20>();
+    add<100>();
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
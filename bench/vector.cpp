@@ -0,0 +1,104 @@
+/// @author: ccat
+
+/// @brief: a batch of 64Ki lookups as `std::vector<expected<row, E>>` and as `expected_vector<row, E>`:
+/// building it, summing the values, counting the failures and asking whether all succeeded
+
+#include "expected_vector.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+struct row {
+    std::int64_t id;
+    double a, b, c;
+};
+
+enum class errc : int { missing = 1 };
+
+constexpr std::size_t batch_size = 1 << 16;
+
+auto make_batch(int percent) ->std::vector<expected<row, errc>> {
+    std::vector<expected<row, errc>> batch;
+    batch.reserve(batch_size);
+    std::uint32_t state = 77;
+    for (std::size_t i = 0; i < batch_size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        if (static_cast<int>(state % 100) < percent) batch.emplace_back(unexpect, errc::missing);
+        else batch.emplace_back(row{static_cast<std::int64_t>(i), 1.0, 2.0, 3.0});
+    }
+    return batch;
+}
+
+const bool registered = [] {
+    for (const int rate : {0, 1, 10, 50}) {
+        const auto suffix = "/failures:" + std::to_string(rate) + "%";
+        ccat_bench::add("build/vector" + suffix, [batch = make_batch(rate)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                std::vector<expected<row, errc>> out;
+                out.reserve(batch.size());
+                for (const auto& x : batch) out.push_back(x);
+                ccat_bench::keep(out.data());
+            }
+        });
+        ccat_bench::add("build/expected_vector" + suffix, [batch = make_batch(rate)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat::expected_vector<row, errc> out;
+                out.reserve(batch.size());
+                for (const auto& x : batch) out.push_back(x);
+                ccat_bench::keep(out.size());
+            }
+        });
+        ccat_bench::add("sum_values/vector" + suffix, [batch = make_batch(rate)](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                std::int64_t sum = 0;
+                for (const auto& x : batch) if (x.has_value()) sum += x->id;
+                ccat_bench::keep(sum);
+            }
+        });
+        ccat_bench::add("sum_values/expected_vector" + suffix, [batch = ccat::expected_vector<row, errc>(make_batch(rate))](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                std::int64_t sum = 0;
+                for (const auto& x : batch.values()) sum += x.id;
+                ccat_bench::keep(sum);
+            }
+        });
+        ccat_bench::add("count_errors/vector" + suffix, [batch = make_batch(rate)](std::uint64_t iterations) mutable {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat_bench::launder(batch);
+                const auto n = std::count_if(batch.begin(), batch.end(), [](const auto& x) { return !x.has_value(); });
+                ccat_bench::keep(n);
+            }
+        });
+        ccat_bench::add("count_errors/expected_vector" + suffix, [batch = ccat::expected_vector<row, errc>(make_batch(rate))](std::uint64_t iterations) mutable {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat_bench::launder(batch);
+                ccat_bench::keep(batch.count_errors());
+            }
+        });
+        ccat_bench::add("all_values/expected_vector" + suffix, [batch = ccat::expected_vector<row, errc>(make_batch(rate))](std::uint64_t iterations) mutable {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat_bench::launder(batch);
+                ccat_bench::keep(batch.all_values());
+            }
+        });
+        ccat_bench::add("all_values/vector" + suffix, [batch = make_batch(rate)](std::uint64_t iterations) mutable {
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                ccat_bench::launder(batch);
+                const bool all = std::all_of(batch.begin(), batch.end(), [](const auto& x) { return x.has_value(); });
+                ccat_bench::keep(all);
+            }
+        });
+    }
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
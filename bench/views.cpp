@@ -0,0 +1,103 @@
+/// @author: ccat
+
+/// @brief: summing the values of 4096 `expected<std::uint64_t, int>`, one in eight failed, lazily through the views
+/// and eagerly by collecting them into a `std::vector` first, over stored elements and over elements generated by
+/// `std::views::transform`, bare and after an `and_then` step. one iteration is one whole sum
+
+#include "expected_views.hpp"
+#include "bench.hpp"
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using record = expected<std::uint64_t, int>;
+
+constexpr std::uint64_t count = 4096;
+
+[[gnu::noinline]] auto parse(std::uint64_t i) ->record {
+    if (i % 8 == 5) return record(unexpect, static_cast<int>(i));
+    return i * 0x9e3779b97f4a7c15u >> 8;
+}
+
+auto check(std::uint64_t x) ->record {
+    if (x % 61 == 0) return record(unexpect, 61);
+    return x ^ 0xff;
+}
+
+const std::vector<record> stored = [] {
+    std::vector<record> v;
+    for (std::uint64_t i = 0; i < count; ++i) v.push_back(parse(i));
+    return v;
+}();
+
+/// @note: read from a `volatile`, so that the sum of a generated range can't be hoisted out of the loop
+volatile std::uint64_t first = 0;
+
+auto generated() {
+    const std::uint64_t from = first;
+    return std::views::iota(from, from + count) | std::views::transform(parse);
+}
+
+template<typename R>
+[[gnu::noinline]] auto sum_lazy(R&& r) ->std::uint64_t {
+    std::uint64_t sum = 0;
+    for (const auto v : std::forward<R>(r) | ccat::views::values) sum += v;
+    return sum;
+}
+
+template<typename R>
+[[gnu::noinline]] auto sum_eager(R&& r) ->std::uint64_t {
+    std::vector<std::uint64_t> values;
+    for (auto&& x : std::forward<R>(r)) {
+        if (x.has_value()) values.push_back(*x);
+    }
+    std::uint64_t sum = 0;
+    for (const auto v : values) sum += v;
+    return sum;
+}
+
+template<typename R>
+[[gnu::noinline]] auto and_then_lazy(R&& r) ->std::uint64_t {
+    std::uint64_t sum = 0;
+    for (const auto v : std::forward<R>(r) | ccat::views::and_then(check) | ccat::views::values) sum += v;
+    return sum;
+}
+
+template<typename R>
+[[gnu::noinline]] auto and_then_eager(R&& r) ->std::uint64_t {
+    std::vector<record> checked;
+    for (auto&& x : std::forward<R>(r)) checked.push_back(std::forward<decltype(x)>(x).and_then(check));
+    std::uint64_t sum = 0;
+    for (const auto& x : checked) {
+        if (x.has_value()) sum += *x;
+    }
+    return sum;
+}
+
+template<typename F>
+auto add(const char* name, F sum) ->void {
+    ccat_bench::add(name, [sum](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; ++i) ccat_bench::keep(sum());
+    });
+}
+
+const bool registered = [] {
+    add("values/stored/lazy", [] { return sum_lazy(stored); });
+    add("values/stored/eager", [] { return sum_eager(stored); });
+    add("values/generated/lazy", [] { return sum_lazy(generated()); });
+    add("values/generated/eager", [] { return sum_eager(generated()); });
+    add("and_then/stored/lazy", [] { return and_then_lazy(stored); });
+    add("and_then/stored/eager", [] { return and_then_eager(stored); });
+    add("and_then/generated/lazy", [] { return and_then_lazy(generated()); });
+    add("and_then/generated/eager", [] { return and_then_eager(generated()); });
+    return true;
+}();
+
+}
+
+CCAT_BENCH_MAIN()
@@ -0,0 +1,26 @@
+/// @author: ccat
+
+/// @brief: `import ccat.expected;` instead of including "expected.hpp", for C++20 builds with modules.
+/// the configuration macros (`CCAT_EXPECTED_LEAN`, `CCAT_EXPECTED_CONTRACT`, ...) must be given when compiling this unit,
+/// and macros such as `CCAT_EXPECTED_LIKELY` aren't exported. the other "expected_*.hpp" headers still need "expected.hpp".
+/// the standard headers are included in the global module fragment, so that only the declarations of "expected.hpp"
+/// itself are attached to the module, and `CCAT_EXPECTED_EXPORT` exports them where they are declared
+module;
+
+#include <type_traits>
+#include <utility>
+#include <tuple>
+#include <new>
+#include <exception>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <system_error>
+#if defined(CCAT_EXPECTED_INSTRUMENT)
+#include "expected_instrument.hpp"
+#endif
+
+export module ccat.expected;
+
+#define CCAT_EXPECTED_EXPORT export
+#include "expected.hpp"
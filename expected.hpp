@@ -4,11 +4,31 @@
 
 #if defined(__cplusplus) && __cplusplus >= 201703L || defined(_MSVC_LANG) && _MSVC_LANG >= 201703L
 #include <type_traits>
-#include <variant>
-#include <optional>
-#include <stdexcept>
+#include <utility>
+#include <tuple>
+#include <new>
+#include <exception>
+#include <cstdio>
+#include <cstdlib>
+/// @brief: define `CCAT_EXPECTED_LEAN` to leave out `<system_error>`, which this header doesn't need, and `<memory>` where
+/// the compiler's builtins stand in for it, i.e. unless `std::construct_at` is needed for C++20 constant expressions.
+/// it only removes includes and never changes a declaration, so translation units may disagree on it
+#if !defined(CCAT_EXPECTED_LEAN) || defined(__cpp_constexpr_dynamic_alloc) || !defined(__GNUC__) && !defined(__clang__) && !defined(_MSC_VER)
+#include <memory>
+#endif
+#if !defined(CCAT_EXPECTED_LEAN)
+#include <system_error>
+#endif
+#if defined(CCAT_EXPECTED_INSTRUMENT)
+#include "expected_instrument.hpp"
+#endif
 
-namespace ccat {
+/// @brief: `export` when this header is included into the purview of the module "expected.cppm", nothing otherwise
+#ifndef CCAT_EXPECTED_EXPORT
+#define CCAT_EXPECTED_EXPORT
+#endif
+
+CCAT_EXPECTED_EXPORT namespace ccat {
 
 template<typename T>
 using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
@@ -41,8 +61,140 @@ struct is_template_unexpected_instance_class<unexpected<X>> {
 template<typename X>
 constexpr bool is_template_unexpected_instance_class_v = is_template_unexpected_instance_class<X>::value;
 
-class bad_expected_access : public std::runtime_error {
-    using std::runtime_error::runtime_error;
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc)
+/// @brief: changing the active member of the storage in constant expressions needs `std::construct_at`
+#define CCAT_EXPECTED_CONSTEXPR_CXX20 constexpr
+#else
+#define CCAT_EXPECTED_CONSTEXPR_CXX20
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CCAT_EXPECTED_COLD __attribute__((noinline, cold))
+#elif defined(_MSC_VER)
+#define CCAT_EXPECTED_COLD __declspec(noinline)
+#else
+#define CCAT_EXPECTED_COLD
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CCAT_EXPECTED_LIKELY(...) __builtin_expect(static_cast<bool>(__VA_ARGS__), 1)
+#define CCAT_EXPECTED_UNLIKELY(...) __builtin_expect(static_cast<bool>(__VA_ARGS__), 0)
+#define CCAT_EXPECTED_FUNCTION __PRETTY_FUNCTION__
+#elif defined(_MSC_VER)
+#define CCAT_EXPECTED_LIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define CCAT_EXPECTED_UNLIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define CCAT_EXPECTED_FUNCTION __FUNCSIG__
+#else
+#define CCAT_EXPECTED_LIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define CCAT_EXPECTED_UNLIKELY(...) static_cast<bool>(__VA_ARGS__)
+#define CCAT_EXPECTED_FUNCTION __func__
+#endif
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_FILE) && __has_builtin(__builtin_LINE) && __has_builtin(__builtin_FUNCTION)
+#define CCAT_EXPECTED_HAS_BUILTIN_LOCATION 1
+#endif
+#elif defined(__GNUC__) || defined(_MSC_VER) && _MSC_VER >= 1926
+#define CCAT_EXPECTED_HAS_BUILTIN_LOCATION 1
+#endif
+
+#if defined(CCAT_EXPECTED_HAS_BUILTIN_LOCATION)
+#define CCAT_EXPECTED_CURRENT_FILE __builtin_FILE()
+#define CCAT_EXPECTED_CURRENT_LINE __builtin_LINE()
+#define CCAT_EXPECTED_CURRENT_FUNCTION __builtin_FUNCTION()
+#else
+#define CCAT_EXPECTED_CURRENT_FILE ""
+#define CCAT_EXPECTED_CURRENT_LINE 0
+#define CCAT_EXPECTED_CURRENT_FUNCTION ""
+#endif
+
+/// @brief: what `operator*`, `operator->` and `error()` do when called in the wrong state.
+/// `CCAT_EXPECTED_CONTRACT_ASSUME` tells the optimizer it can't happen, so the accessors are a plain load,
+/// `CCAT_EXPECTED_CONTRACT_TRAP` executes a trap instruction, and `CCAT_EXPECTED_CONTRACT_DIAGNOSE` prints
+/// the accessor and the `expected` type to `stderr` and aborts. the default follows `assert`: diagnose unless `NDEBUG`
+#define CCAT_EXPECTED_CONTRACT_ASSUME 0
+#define CCAT_EXPECTED_CONTRACT_TRAP 1
+#define CCAT_EXPECTED_CONTRACT_DIAGNOSE 2
+#ifndef CCAT_EXPECTED_CONTRACT
+#if defined(NDEBUG)
+#define CCAT_EXPECTED_CONTRACT CCAT_EXPECTED_CONTRACT_ASSUME
+#else
+#define CCAT_EXPECTED_CONTRACT CCAT_EXPECTED_CONTRACT_DIAGNOSE
+#endif
+#endif
+
+/// @brief: define `CCAT_EXPECTED_INSTRUMENT` to count, per call site and per thread, every error made with `unexpected(e)`
+/// and every `bad_expected_access` thrown, see "expected_instrument.hpp". `unexpect` and in-place constructions aren't
+/// counted since the monadic members use them to pass an existing error along.
+/// errors made during constant evaluation aren't counted, nor any error where the compiler can't tell that apart
+#if defined(CCAT_EXPECTED_INSTRUMENT)
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER) && _MSC_VER >= 1925
+#define CCAT_EXPECTED_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#elif defined(__cpp_lib_is_constant_evaluated)
+#define CCAT_EXPECTED_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define CCAT_EXPECTED_IS_CONSTANT_EVALUATED() true
+#endif
+#define CCAT_EXPECTED_SITE_PARAMS , const char* site_file_ = CCAT_EXPECTED_CURRENT_FILE, \
+    unsigned site_line_ = CCAT_EXPECTED_CURRENT_LINE, const char* site_function_ = CCAT_EXPECTED_CURRENT_FUNCTION
+#define CCAT_EXPECTED_RECORD_FAILURE(...) \
+    (CCAT_EXPECTED_IS_CONSTANT_EVALUATED() ? void(0) : ::ccat::detail::record_failure<__VA_ARGS__>(site_file_, site_line_, site_function_))
+#define CCAT_EXPECTED_RECORD_THROW(...) ::ccat::detail::record_throw<__VA_ARGS__>()
+#else
+#define CCAT_EXPECTED_SITE_PARAMS
+#define CCAT_EXPECTED_RECORD_FAILURE(...) void(0)
+#define CCAT_EXPECTED_RECORD_THROW(...) void(0)
+#endif
+
+#if CCAT_EXPECTED_CONTRACT == CCAT_EXPECTED_CONTRACT_DIAGNOSE
+#define CCAT_EXPECTED_EXPECTS(cond, what) ((cond) ? void(0) : ::ccat::detail::contract_violation(what, CCAT_EXPECTED_FUNCTION))
+#elif CCAT_EXPECTED_CONTRACT == CCAT_EXPECTED_CONTRACT_TRAP
+#define CCAT_EXPECTED_EXPECTS(cond, what) ((cond) ? void(0) : ::ccat::detail::contract_violation())
+#elif defined(__GNUC__) || defined(__clang__)
+#define CCAT_EXPECTED_EXPECTS(cond, what) ((cond) ? void(0) : __builtin_unreachable())
+#elif defined(_MSC_VER)
+#define CCAT_EXPECTED_EXPECTS(cond, what) __assume(cond)
+#else
+#define CCAT_EXPECTED_EXPECTS(cond, what) void(0)
+#endif
+
+template<typename E>
+class bad_expected_access;
+
+template<>
+class bad_expected_access<void> : public std::exception {
+public:
+    auto what() const noexcept ->const char* override {
+        return "ccat::bad_expected_access: this expect has no value";
+    }
+protected:
+    bad_expected_access() noexcept = default;
+    bad_expected_access(const bad_expected_access&) = default;
+    bad_expected_access(bad_expected_access&&) = default;
+    ~bad_expected_access() override = default;
+    auto operator= (const bad_expected_access&) ->bad_expected_access& = default;
+    auto operator= (bad_expected_access&&) ->bad_expected_access& = default;
+};
+
+template<typename E>
+class bad_expected_access : public bad_expected_access<void> {
+public:
+    explicit bad_expected_access(E e_) : e(std::move(e_)) {}
+
+    auto error() & noexcept ->E& {
+        return e;
+    }
+    auto error() const& noexcept ->const E& {
+        return e;
+    }
+    auto error() && noexcept ->E&& {
+        return std::move(e);
+    }
+    auto error() const&& noexcept ->const E&& {
+        return std::move(e);
+    }
+private:
+    E e;
 };
 
 struct unexpect_t {
@@ -52,6 +204,482 @@ inline constexpr unexpect_t unexpect{};
 using std::in_place_t;
 using std::in_place;
 
+/// @brief: customization point declaring a value of `T` that never represents a valid object,
+/// specializations provide `has_niche = true`, `niche()` and `is_niche(const T&)`. there are none built in: a niche is
+/// only taken when the program opts in, since it makes that value unrepresentable in the `expected`.
+/// `expected` then stores its discriminator inside that value instead of beside it:
+/// `expected<void, E>` with a niche `E`, and `expected<T, E>` with a niche `T` and an empty `E`
+/// @warning: constructing an `expected` from the niche value violates its precondition, see `CCAT_EXPECTED_CONTRACT`
+template<typename T, typename = void>
+struct niche_traits {
+    constexpr static bool has_niche = false;
+};
+
+namespace detail {
+
+#if CCAT_EXPECTED_CONTRACT == CCAT_EXPECTED_CONTRACT_DIAGNOSE
+[[noreturn]] CCAT_EXPECTED_COLD inline auto contract_violation(const char* what, const char* where) noexcept ->void {
+    std::fprintf(stderr, "ccat::expected: %s\n    in %s\n", what, where);
+    std::abort();
+}
+#elif CCAT_EXPECTED_CONTRACT == CCAT_EXPECTED_CONTRACT_TRAP
+[[noreturn]] inline auto contract_violation() noexcept ->void {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_trap();
+#else
+    std::terminate();
+#endif
+}
+#endif
+
+/// @brief: kept out of line so that the `value()` fast path inlines to a single branch
+template<typename Err>
+[[noreturn]] CCAT_EXPECTED_COLD auto throw_bad_expected_access(Err&& e) ->void {
+    CCAT_EXPECTED_RECORD_THROW(remove_cvref_t<Err>);
+    throw bad_expected_access<remove_cvref_t<Err>>(std::forward<Err>(e));
+}
+
+struct construct_from_t {
+    explicit construct_from_t() = default;
+};
+inline constexpr construct_from_t construct_from{};
+
+/// @brief: stand-in for `T` in the storage of `expected<void, E>`
+struct void_value {};
+
+template<typename T>
+constexpr bool is_trivially_copyable_storage_v =
+    std::is_trivially_copy_constructible_v<T> && std::is_trivially_move_constructible_v<T> &&
+    std::is_trivially_copy_assignable_v<T> && std::is_trivially_move_assignable_v<T> &&
+    std::is_trivially_destructible_v<T>;
+
+template<typename T>
+constexpr bool is_nothrow_copy_assignable_storage_v = std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>;
+template<typename T>
+constexpr bool is_nothrow_move_assignable_storage_v = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
+template<typename T>
+constexpr bool is_nothrow_swappable_storage_v = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>;
+
+/// @brief: `std::addressof` without `<memory>`, every major compiler has the builtin behind it
+template<typename T>
+constexpr auto addressof(T& x) noexcept ->T* {
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+    return __builtin_addressof(x);
+#else
+    return std::addressof(x);
+#endif
+}
+template<typename T>
+auto addressof(const T&&) ->const T* = delete;
+
+template<typename T, typename... Args>
+CCAT_EXPECTED_CONSTEXPR_CXX20 auto construct_at(T* p, Args&&... args) ->T* {
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+    return std::construct_at(p, std::forward<Args>(args)...);
+#else
+    return ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+#endif
+}
+template<typename T>
+CCAT_EXPECTED_CONSTEXPR_CXX20 auto destroy_at(T* p) noexcept ->void {
+    p->~T();
+}
+
+/// @brief: destroys `*old_val` and constructs `*new_val` from `args`, restoring `*old_val` if the construction throws
+template<typename New, typename Old, typename... Args>
+CCAT_EXPECTED_CONSTEXPR_CXX20 auto reinit(New* new_val, Old* old_val, Args&&... args) ->void {
+    if constexpr (std::is_nothrow_constructible_v<New, Args...>) {
+        detail::destroy_at(old_val);
+        detail::construct_at(new_val, std::forward<Args>(args)...);
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<New>) {
+        New tmp(std::forward<Args>(args)...);
+        detail::destroy_at(old_val);
+        detail::construct_at(new_val, std::move(tmp));
+    }
+    else {
+        Old tmp(std::move(*old_val));
+        detail::destroy_at(old_val);
+        try {
+            detail::construct_at(new_val, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            detail::construct_at(old_val, std::move(tmp));
+            throw;
+        }
+    }
+}
+
+template<typename T, typename E, bool = std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>>
+union expected_union {
+    constexpr expected_union() noexcept : dummy_() {}
+    template<typename... Args>
+    constexpr explicit expected_union(std::in_place_t, Args&&... args) : value_(std::forward<Args>(args)...) {}
+    template<typename... Args>
+    constexpr explicit expected_union(unexpect_t, Args&&... args) : error_(std::forward<Args>(args)...) {}
+
+    char dummy_;
+    T value_;
+    E error_;
+};
+
+template<typename T, typename E>
+union expected_union<T, E, false> {
+    constexpr expected_union() noexcept : dummy_() {}
+    template<typename... Args>
+    constexpr explicit expected_union(std::in_place_t, Args&&... args) : value_(std::forward<Args>(args)...) {}
+    template<typename... Args>
+    constexpr explicit expected_union(unexpect_t, Args&&... args) : error_(std::forward<Args>(args)...) {}
+    CCAT_EXPECTED_CONSTEXPR_CXX20 ~expected_union() {}
+
+    char dummy_;
+    T value_;
+    E error_;
+};
+
+/// @brief: the union of `T` and `E` plus the discriminator, with no special members of its own
+template<typename T, typename E>
+struct expected_storage_data {
+    template<typename U = T, typename = std::enable_if_t<std::is_default_constructible_v<U>>>
+    constexpr expected_storage_data() : storage_(std::in_place), has_value_(true) {}
+    template<typename... Args>
+    constexpr explicit expected_storage_data(std::in_place_t, Args&&... args) : storage_(std::in_place, std::forward<Args>(args)...), has_value_(true) {}
+    template<typename... Args>
+    constexpr explicit expected_storage_data(unexpect_t, Args&&... args) : storage_(unexpect, std::forward<Args>(args)...), has_value_(false) {}
+    template<typename Other>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 expected_storage_data(construct_from_t, Other&& other) : storage_(), has_value_(other.has_value_) {
+        if (has_value_)
+            detail::construct_at(detail::addressof(storage_.value_), std::forward<Other>(other).storage_.value_);
+        else
+            detail::construct_at(detail::addressof(storage_.error_), std::forward<Other>(other).storage_.error_);
+    }
+
+    constexpr auto contains_value() const noexcept ->bool {
+        return has_value_;
+    }
+    constexpr auto get_value() & noexcept ->T& {
+        return storage_.value_;
+    }
+    constexpr auto get_value() const& noexcept ->const T& {
+        return storage_.value_;
+    }
+    constexpr auto get_error() & noexcept ->E& {
+        return storage_.error_;
+    }
+    constexpr auto get_error() const& noexcept ->const E& {
+        return storage_.error_;
+    }
+
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto destroy() noexcept ->void {
+        if (has_value_)
+            detail::destroy_at(detail::addressof(storage_.value_));
+        else
+            detail::destroy_at(detail::addressof(storage_.error_));
+    }
+
+    template<typename... Args>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace_value(Args&&... args) ->void {
+        if (has_value_)
+            detail::reinit(detail::addressof(storage_.value_), detail::addressof(storage_.value_), std::forward<Args>(args)...);
+        else {
+            detail::reinit(detail::addressof(storage_.value_), detail::addressof(storage_.error_), std::forward<Args>(args)...);
+            has_value_ = true;
+        }
+    }
+    template<typename... Args>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace_error(Args&&... args) ->void {
+        if (has_value_) {
+            detail::reinit(detail::addressof(storage_.error_), detail::addressof(storage_.value_), std::forward<Args>(args)...);
+            has_value_ = false;
+        }
+        else
+            detail::reinit(detail::addressof(storage_.error_), detail::addressof(storage_.error_), std::forward<Args>(args)...);
+    }
+
+    template<typename Other>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto assign_from(Other&& other) ->void {
+        if (has_value_ && other.has_value_)
+            storage_.value_ = std::forward<Other>(other).storage_.value_;
+        else if (!has_value_ && !other.has_value_)
+            storage_.error_ = std::forward<Other>(other).storage_.error_;
+        else if (other.has_value_)
+            emplace_value(std::forward<Other>(other).storage_.value_);
+        else
+            emplace_error(std::forward<Other>(other).storage_.error_);
+    }
+
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected_storage_data& other)
+        noexcept(is_nothrow_swappable_storage_v<T> && is_nothrow_swappable_storage_v<E>) ->void {
+        using std::swap;
+        if (has_value_ && other.has_value_)
+            swap(storage_.value_, other.storage_.value_);
+        else if (!has_value_ && !other.has_value_)
+            swap(storage_.error_, other.storage_.error_);
+        else if (!has_value_)
+            other.swap(*this);
+        else if constexpr (std::is_nothrow_move_constructible_v<E>) {
+            E tmp(std::move(other.storage_.error_));
+            detail::destroy_at(detail::addressof(other.storage_.error_));
+            if constexpr (std::is_nothrow_move_constructible_v<T>)
+                detail::construct_at(detail::addressof(other.storage_.value_), std::move(storage_.value_));
+            else {
+                try {
+                    detail::construct_at(detail::addressof(other.storage_.value_), std::move(storage_.value_));
+                }
+                catch (...) {
+                    detail::construct_at(detail::addressof(other.storage_.error_), std::move(tmp));
+                    throw;
+                }
+            }
+            detail::destroy_at(detail::addressof(storage_.value_));
+            detail::construct_at(detail::addressof(storage_.error_), std::move(tmp));
+            has_value_ = false;
+            other.has_value_ = true;
+        }
+        else {
+            T tmp(std::move(storage_.value_));
+            detail::destroy_at(detail::addressof(storage_.value_));
+            try {
+                detail::construct_at(detail::addressof(storage_.error_), std::move(other.storage_.error_));
+                detail::destroy_at(detail::addressof(other.storage_.error_));
+                detail::construct_at(detail::addressof(other.storage_.value_), std::move(tmp));
+            }
+            catch (...) {
+                detail::construct_at(detail::addressof(storage_.value_), std::move(tmp));
+                throw;
+            }
+            has_value_ = false;
+            other.has_value_ = true;
+        }
+    }
+
+    expected_union<T, E> storage_;
+    bool has_value_;
+};
+
+template<typename T, typename E, bool = std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>>
+struct expected_storage_base : expected_storage_data<T, E> {
+    using expected_storage_data<T, E>::expected_storage_data;
+};
+
+template<typename T, typename E>
+struct expected_storage_base<T, E, false> : expected_storage_data<T, E> {
+    using expected_storage_data<T, E>::expected_storage_data;
+    expected_storage_base() = default;
+    expected_storage_base(const expected_storage_base&) = default;
+    expected_storage_base(expected_storage_base&&) = default;
+    CCAT_EXPECTED_CONSTEXPR_CXX20 ~expected_storage_base() {
+        this->destroy();
+    }
+    auto operator= (const expected_storage_base&) ->expected_storage_base& = default;
+    auto operator= (expected_storage_base&&) ->expected_storage_base& = default;
+};
+
+/// @brief: copy/move members are trivial whenever they are trivial for both `T` and `E`
+template<typename T, typename E, bool = is_trivially_copyable_storage_v<T> && is_trivially_copyable_storage_v<E>>
+struct expected_copy_base : expected_storage_base<T, E> {
+    using expected_storage_base<T, E>::expected_storage_base;
+};
+
+template<typename T, typename E>
+struct expected_copy_base<T, E, false> : expected_storage_base<T, E> {
+    using expected_storage_base<T, E>::expected_storage_base;
+    expected_copy_base() = default;
+    CCAT_EXPECTED_CONSTEXPR_CXX20 expected_copy_base(const expected_copy_base& other)
+        noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_constructible_v<E>)
+        : expected_storage_base<T, E>(construct_from, other) {}
+    CCAT_EXPECTED_CONSTEXPR_CXX20 expected_copy_base(expected_copy_base&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>)
+        : expected_storage_base<T, E>(construct_from, std::move(other)) {}
+    ~expected_copy_base() = default;
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (const expected_copy_base& other)
+        noexcept(is_nothrow_copy_assignable_storage_v<T> && is_nothrow_copy_assignable_storage_v<E>)
+        ->expected_copy_base& {
+        this->assign_from(other);
+        return *this;
+    }
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (expected_copy_base&& other)
+        noexcept(is_nothrow_move_assignable_storage_v<T> && is_nothrow_move_assignable_storage_v<E>)
+        ->expected_copy_base& {
+        this->assign_from(std::move(other));
+        return *this;
+    }
+};
+
+/// @brief: empty bases deleting the special members `T` or `E` can't support
+template<bool>
+struct enable_copy_construct {};
+template<>
+struct enable_copy_construct<false> {
+    enable_copy_construct() = default;
+    enable_copy_construct(const enable_copy_construct&) = delete;
+    enable_copy_construct(enable_copy_construct&&) = default;
+    auto operator= (const enable_copy_construct&) ->enable_copy_construct& = default;
+    auto operator= (enable_copy_construct&&) ->enable_copy_construct& = default;
+};
+
+template<bool>
+struct enable_move_construct {};
+template<>
+struct enable_move_construct<false> {
+    enable_move_construct() = default;
+    enable_move_construct(const enable_move_construct&) = default;
+    enable_move_construct(enable_move_construct&&) = delete;
+    auto operator= (const enable_move_construct&) ->enable_move_construct& = default;
+    auto operator= (enable_move_construct&&) ->enable_move_construct& = default;
+};
+
+template<bool>
+struct enable_copy_assign {};
+template<>
+struct enable_copy_assign<false> {
+    enable_copy_assign() = default;
+    enable_copy_assign(const enable_copy_assign&) = default;
+    enable_copy_assign(enable_copy_assign&&) = default;
+    auto operator= (const enable_copy_assign&) ->enable_copy_assign& = delete;
+    auto operator= (enable_copy_assign&&) ->enable_copy_assign& = default;
+};
+
+template<bool>
+struct enable_move_assign {};
+template<>
+struct enable_move_assign<false> {
+    enable_move_assign() = default;
+    enable_move_assign(const enable_move_assign&) = default;
+    enable_move_assign(enable_move_assign&&) = default;
+    auto operator= (const enable_move_assign&) ->enable_move_assign& = default;
+    auto operator= (enable_move_assign&&) ->enable_move_assign& = delete;
+};
+
+template<typename T, typename E>
+struct expected_enable_special_members :
+    enable_copy_construct<std::is_copy_constructible_v<T> && std::is_copy_constructible_v<E>>,
+    enable_move_construct<std::is_move_constructible_v<T> && std::is_move_constructible_v<E>>,
+    enable_copy_assign<
+        std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T> &&
+        std::is_copy_constructible_v<E> && std::is_copy_assignable_v<E>
+    >,
+    enable_move_assign<
+        std::is_move_constructible_v<T> && std::is_move_assignable_v<T> &&
+        std::is_move_constructible_v<E> && std::is_move_assignable_v<E>
+    > {};
+
+/// @brief: the niche of the pointer stored by `expected<T&, E>`, which is never null since it is taken from a reference
+template<typename T>
+struct reference_niche_traits {
+    constexpr static bool has_niche = true;
+    constexpr static auto niche() noexcept ->T* {
+        return nullptr;
+    }
+    constexpr static auto is_niche(T* p) noexcept ->bool {
+        return p == nullptr;
+    }
+};
+
+template<typename T, typename E>
+using default_niche_traits = niche_traits<std::conditional_t<std::is_same_v<T, void_value>, E, T>>;
+
+template<typename T, typename E, typename Traits = default_niche_traits<T, E>>
+constexpr bool is_niche_storage_v = std::is_same_v<T, void_value> ?
+    Traits::has_niche && std::is_trivially_copyable_v<E> :
+    Traits::has_niche && std::is_trivially_copyable_v<T> &&
+    std::is_empty_v<E> && !std::is_final_v<E> && std::is_trivially_copyable_v<E> && std::is_default_constructible_v<E>;
+
+/// @brief: `expected<void, E>` whose error holds `Traits::niche()` while it has a value
+template<typename T, typename E, typename Traits, bool = std::is_same_v<T, void_value>>
+struct expected_niche_storage {
+    constexpr expected_niche_storage() noexcept : error_(Traits::niche()) {}
+    constexpr explicit expected_niche_storage(std::in_place_t) noexcept : error_(Traits::niche()) {}
+    template<typename... Args>
+    constexpr explicit expected_niche_storage(unexpect_t, Args&&... args) : error_(std::forward<Args>(args)...) {
+        CCAT_EXPECTED_EXPECTS(!Traits::is_niche(error_), "the error of an `expected` constructed from its niche value");
+    }
+
+    constexpr auto contains_value() const noexcept ->bool {
+        return Traits::is_niche(error_);
+    }
+    constexpr auto get_error() & noexcept ->E& {
+        return error_;
+    }
+    constexpr auto get_error() const& noexcept ->const E& {
+        return error_;
+    }
+
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace_value() noexcept ->void {
+        error_ = Traits::niche();
+    }
+    template<typename... Args>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace_error(Args&&... args) ->void {
+        error_ = E(std::forward<Args>(args)...);
+        CCAT_EXPECTED_EXPECTS(!Traits::is_niche(error_), "the error of an `expected` constructed from its niche value");
+    }
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected_niche_storage& other) noexcept ->void {
+        using std::swap;
+        swap(error_, other.error_);
+    }
+
+    E error_;
+};
+
+/// @brief: `expected<T, E>` with an empty `E` whose value holds `Traits::niche()` while it has an error.
+/// the error is an empty base, so every object has its own without taking any room
+template<typename T, typename E, typename Traits>
+struct expected_niche_storage<T, E, Traits, false> : private E {
+    constexpr expected_niche_storage() : expected_niche_storage(std::in_place) {}
+    template<typename... Args>
+    constexpr explicit expected_niche_storage(std::in_place_t, Args&&... args) : E(), value_(std::forward<Args>(args)...) {
+        CCAT_EXPECTED_EXPECTS(!Traits::is_niche(value_), "the value of an `expected` constructed from its niche value");
+    }
+    template<typename... Args>
+    constexpr explicit expected_niche_storage(unexpect_t, Args&&... args) : E(std::forward<Args>(args)...), value_(Traits::niche()) {}
+
+    constexpr auto contains_value() const noexcept ->bool {
+        return !Traits::is_niche(value_);
+    }
+    constexpr auto get_value() & noexcept ->T& {
+        return value_;
+    }
+    constexpr auto get_value() const& noexcept ->const T& {
+        return value_;
+    }
+    constexpr auto get_error() & noexcept ->E& {
+        return *this;
+    }
+    constexpr auto get_error() const& noexcept ->const E& {
+        return *this;
+    }
+
+    template<typename... Args>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace_value(Args&&... args) ->void {
+        value_ = T(std::forward<Args>(args)...);
+        CCAT_EXPECTED_EXPECTS(!Traits::is_niche(value_), "the value of an `expected` constructed from its niche value");
+    }
+    template<typename... Args>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace_error(Args&&... args) ->void {
+        get_error() = E(std::forward<Args>(args)...);
+        value_ = Traits::niche();
+    }
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected_niche_storage& other) noexcept ->void {
+        using std::swap;
+        swap(value_, other.value_);
+        swap(get_error(), other.get_error());
+    }
+
+    T value_;
+};
+
+template<typename T, typename E, typename Traits = default_niche_traits<T, E>>
+using expected_base_t = std::conditional_t<is_niche_storage_v<T, E, Traits>, expected_niche_storage<T, E, Traits>, expected_copy_base<T, E>>;
+
+template<typename T, typename E>
+struct expected_layout;
+
+/// @brief: `transform` of an lvalue keeps an lvalue reference returned by `f` as an `expected<U&, E>` instead of copying
+template<typename R, typename E>
+using transform_lvalue_result_t = expected<std::conditional_t<std::is_lvalue_reference_v<R>, R, remove_cvref_t<R>>, E>;
+
+}
+
 template<typename E>
 class unexpected {
     static_assert(std::is_object_v<E>, "type `E` must be an object-type");
@@ -63,34 +691,40 @@ public:
     unexpected(unexpected&&) = default;
     ~unexpected() = default;
 
-    template<typename Err = E>
-    explicit unexpected(Err&& e_) : e(std::forward<Err>(e_)) {}
+    template<typename Err = E, typename = std::enable_if_t<
+        !std::is_same_v<remove_cvref_t<Err>, unexpected> && !std::is_same_v<remove_cvref_t<Err>, std::in_place_t> &&
+        std::is_constructible_v<E, Err>
+    >>
+    constexpr explicit unexpected(Err&& e_ CCAT_EXPECTED_SITE_PARAMS) noexcept(std::is_nothrow_constructible_v<E, Err>) : e(std::forward<Err>(e_)) {
+        CCAT_EXPECTED_RECORD_FAILURE(E);
+    }
     template<typename... Args>
-    explicit unexpected(std::in_place_t, Args&&... args ) : e(std::forward<Args>(args)...) {}
+    constexpr explicit unexpected(std::in_place_t, Args&&... args ) noexcept(std::is_nothrow_constructible_v<E, Args...>) : e(std::forward<Args>(args)...) {}
     template<typename U, typename... Args>
-    explicit unexpected(std::in_place_t, std::initializer_list<U> il, Args&&... args ) : e(il, std::forward<Args>(args)...) {}
+    constexpr explicit unexpected(std::in_place_t, std::initializer_list<U> il, Args&&... args )
+        noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<U>&, Args...>) : e(il, std::forward<Args>(args)...) {}
 
-    auto error() & noexcept ->E& {
+    constexpr auto error() & noexcept ->E& {
         return e;
     }
-    auto error() const& noexcept ->const E& {
+    constexpr auto error() const& noexcept ->const E& {
         return e;
     }
-    auto error() && noexcept ->E&& {
+    constexpr auto error() && noexcept ->E&& {
         return std::move(e);
     }
-    auto error() const&& noexcept ->const E&& {
+    constexpr auto error() const&& noexcept ->const E&& {
         return std::move(e);
     }
-    auto swap(unexpected& other) ->void {
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(unexpected& other) noexcept(std::is_nothrow_swappable_v<E>) ->void {
         std::swap(e, other.e);
     }
     template<typename E2>
-    friend auto operator==(const unexpected<E>& x, const unexpected<E2>& y) ->bool {
+    friend constexpr auto operator==(const unexpected<E>& x, const unexpected<E2>& y) ->bool {
         return x.e == y.e;
     }
     template<typename E2>
-    friend auto operator!=(const unexpected<E>& x, const unexpected<E2>& y) ->bool {
+    friend constexpr auto operator!=(const unexpected<E>& x, const unexpected<E2>& y) ->bool {
         return x.e != y.e;
     }
 private:
@@ -101,12 +735,15 @@ template<typename E>
 unexpected(E) -> unexpected<E>;
 
 template<typename T, typename E>
-class expected {
+class expected : private detail::expected_base_t<T, E>, private detail::expected_enable_special_members<T, E> {
     static_assert(std::is_destructible_v<T>, "type `T` must be destructible");
     static_assert(std::is_object_v<E>, "type `E` must be an object-type");
     static_assert(!std::is_array_v<E>, "type `E` can't be an array-type");
     static_assert(!std::is_const_v<E> && !std::is_volatile_v<E>, "cv qualifiers can't be applied to type `E`");
     static_assert(std::is_move_constructible_v<E>, "type `E` must be move-constructible");
+
+    using base_type = detail::expected_base_t<T, E>;
+    friend struct detail::expected_layout<T, E>;
 public:
     using value_type = T;
     using error_type = E;
@@ -118,276 +755,590 @@ public:
     expected(const expected&) = default;
     expected(expected&&) = default;
 
-    expected(const T& t) : context_(t) {}
-    expected(T&& t) : context_(std::move(t)) {}
+    constexpr expected(const T& t) noexcept(std::is_nothrow_copy_constructible_v<T>) : base_type(std::in_place, t) {}
+    constexpr expected(T&& t) noexcept(std::is_nothrow_move_constructible_v<T>) : base_type(std::in_place, std::move(t)) {}
 
     template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-    expected(U&& u) : context_(std::in_place_index<0>, std::forward<U>(u)) {}
+    constexpr expected(U&& u) noexcept(std::is_nothrow_constructible_v<T, U>) : base_type(std::in_place, std::forward<U>(u)) {}
     template<typename G>
-    expected(const unexpected<G>& e) : expected(unexpect, e.error()) {}
+    constexpr expected(const unexpected<G>& e) noexcept(std::is_nothrow_constructible_v<E, const G&>) : expected(unexpect, e.error()) {}
     template<typename G>
-    expected(unexpected<G>&& e) : expected(unexpect, std::move(e.error())) {}
+    constexpr expected(unexpected<G>&& e) noexcept(std::is_nothrow_constructible_v<E, G>) : expected(unexpect, std::move(e.error())) {}
 
 
     template<typename... Args>
-    explicit expected(std::in_place_t, Args&&... args) : context_(std::in_place_index<0>, std::forward<Args>(args)...) {}
+    constexpr explicit expected(std::in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+        : base_type(std::in_place, std::forward<Args>(args)...) {}
 	template<typename U, typename... Args>
-    explicit expected(std::in_place_t, std::initializer_list<U> il, Args&&... args) : context_(std::in_place_index<0>, il, std::forward<Args>(args)...) {}
+    constexpr explicit expected(std::in_place_t, std::initializer_list<U> il, Args&&... args)
+        noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>)
+        : base_type(std::in_place, il, std::forward<Args>(args)...) {}
 
     template<typename... Args>
-    explicit expected(unexpect_t, Args&&... args ) : context_(std::in_place_index<1>, std::forward<Args>(args)...) {}
+    constexpr explicit expected(unexpect_t, Args&&... args ) noexcept(std::is_nothrow_constructible_v<E, Args...>)
+        : base_type(unexpect, std::forward<Args>(args)...) {}
     template<typename U, typename... Args>
-    explicit expected(unexpect_t, std::initializer_list<U> il, Args&&... args ) : context_(std::in_place_index<1>, il, std::forward<Args>(args)...) {}
+    constexpr explicit expected(unexpect_t, std::initializer_list<U> il, Args&&... args )
+        noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<U>&, Args...>)
+        : base_type(unexpect, il, std::forward<Args>(args)...) {}
 
     ~expected() = default;
 
     auto operator= (const expected&) ->expected& = default;
     auto operator= (expected&&) ->expected& = default;
-    template<typename G = T>
-    auto operator= (G&& t) ->expected& {
-        context_.template emplace<0>(std::forward<G>(t));
+    template<typename G = T, typename = std::enable_if_t<
+        !std::is_same_v<remove_cvref_t<G>, expected> && !is_template_unexpected_instance_class_v<remove_cvref_t<G>>
+    >>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (G&& t) noexcept(std::is_nothrow_constructible_v<T, G>) ->expected& {
+        this->emplace_value(std::forward<G>(t));
         return *this;
     }
     template<typename G>
-    auto operator= (const unexpected<G>& other) ->expected& {
-        context_.template emplace<1>(other.error());
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (const unexpected<G>& other) noexcept(std::is_nothrow_constructible_v<E, const G&>) ->expected& {
+        this->emplace_error(other.error());
         return *this;
     }
     template<typename G>
-    auto operator= (unexpected<G>&& other ) ->expected& {
-        context_.template emplace<1>(std::move(other.error()));
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (unexpected<G>&& other ) noexcept(std::is_nothrow_constructible_v<E, G>) ->expected& {
+        this->emplace_error(std::move(other.error()));
         return *this;
     }
 
     template<typename... Args>
-    auto emplace(Args&&... args) noexcept ->T& {
-        context_.template emplace<0>(std::forward<Args>(args)...);
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) ->T& {
+        this->emplace_value(std::forward<Args>(args)...);
         return value();
     }
 	template<typename U, typename... Args>
-	auto emplace(std::initializer_list<U> il, Args&&... args) noexcept ->T& {
-        context_.template emplace<0>(il, std::forward<Args>(args)...);
+	CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace(std::initializer_list<U> il, Args&&... args)
+        noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>) ->T& {
+        this->emplace_value(il, std::forward<Args>(args)...);
         return value();
     }
-    auto has_value() const noexcept ->bool {
-        return context_.index() == 0;
+    constexpr auto has_value() const noexcept ->bool {
+        return this->contains_value();
     }
-	explicit operator bool() const noexcept {
+	constexpr explicit operator bool() const noexcept {
 		return has_value();
 	}
 
-    auto error() & noexcept ->E& {
+    constexpr auto error() & noexcept ->E& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return std::get<1>(context_);
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return this->get_error();
     }
-	auto error() && noexcept ->E&& {
+	constexpr auto error() && noexcept ->E&& {
 		/// @warning: if result of `has_value` is true, the behavior is undefined
-		return std::move(std::get<1>(context_));
+		CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+		return std::move(this->get_error());
 	}
-	auto error() const& noexcept ->const E& {
+	constexpr auto error() const& noexcept ->const E& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return std::get<1>(context_);
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return this->get_error();
     }
-	auto error() const&& noexcept ->const E&& {
+	constexpr auto error() const&& noexcept ->const E&& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return std::move(std::get<1>(context_));
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return std::move(this->get_error());
     }
 
-    auto value() & ->T& {
-        if (!has_value()) throw bad_expected_access("ccat::bad_expected_access: this expect has no value");
-        return std::get<0>(context_);
+    constexpr auto value() & ->T& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(error());
+        return this->get_value();
     }
-	auto value() && ->T&& {
-        if (!has_value()) throw bad_expected_access("ccat::bad_expected_access: this expect has no value");
-        return std::move(std::get<0>(context_));
+	constexpr auto value() && ->T&& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(std::move(error()));
+        return std::move(this->get_value());
     }
-    auto value() const& ->const T& {
-        if (!has_value()) throw bad_expected_access("ccat::bad_expected_access: this expect has no value");
-        return std::get<0>(context_);
+    constexpr auto value() const& ->const T& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(error());
+        return this->get_value();
     }
-	auto value() const&& ->const T&& {
-        if (!has_value()) throw bad_expected_access("ccat::bad_expected_access: this expect has no value");
-        return std::move(std::get<0>(context_));
+	constexpr auto value() const&& ->const T&& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(std::move(error()));
+        return std::move(this->get_value());
     }
 	template<typename U>
-	auto value_or(U&& default_value) const& ->T {
+	constexpr auto value_or(U&& default_value) const& ->T {
 		static_assert(std::is_convertible_v<U, T>, "there is no conversion from `U` to `T`");
-		if (has_value()) return std::get<0>(context_);
+		if (CCAT_EXPECTED_LIKELY(has_value())) return this->get_value();
 		return std::forward<U>(default_value);
 	}
 	template<typename U>
-	auto value_or(U&& default_value) && ->T {
+	constexpr auto value_or(U&& default_value) && ->T {
 		static_assert(std::is_convertible_v<U, T>, "there is no conversion from `U` to `T`");
-		if (has_value()) return std::move(std::get<0>(context_));
+		if (CCAT_EXPECTED_LIKELY(has_value())) return std::move(this->get_value());
 		return std::forward<U>(default_value);
 	}
-    auto operator*() & noexcept ->T& {
+    constexpr auto operator*() & noexcept ->T& {
         /// @warning: if result of `has_value` is false, the behavior is undefined
-        return std::get<0>(context_);
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected` holding an error");
+        return this->get_value();
     }
-	auto operator*() && noexcept ->T&& {
+	constexpr auto operator*() && noexcept ->T&& {
         /// @warning: if result of `has_value` is false, the behavior is undefined
-        return std::move(std::get<0>(context_));
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected` holding an error");
+        return std::move(this->get_value());
     }
-    auto operator*() const& noexcept ->const T& {
+    constexpr auto operator*() const& noexcept ->const T& {
         /// @warning: if result of `has_value` is false, the behavior is undefined
-        return std::get<0>(context_);
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected` holding an error");
+        return this->get_value();
     }
-	auto operator*() const&& noexcept ->const T&& {
+	constexpr auto operator*() const&& noexcept ->const T&& {
         /// @warning: if result of `has_value` is false, the behavior is undefined
-        return std::move(std::get<0>(context_));
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected` holding an error");
+        return std::move(this->get_value());
     }
-    auto operator->() noexcept ->T* {
+    constexpr auto operator->() noexcept ->T* {
         /// @warning: if result of `has_value` is false, the behavior is undefined
-        return &std::get<0>(context_);
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator->` called on an `expected` holding an error");
+        return detail::addressof(this->get_value());
     }
-    auto operator->() const noexcept ->const T* {
+    constexpr auto operator->() const noexcept ->const T* {
         /// @warning: if result of `has_value` is false, the behavior is undefined
-        return &std::get<0>(context_);
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator->` called on an `expected` holding an error");
+        return detail::addressof(this->get_value());
     }
 
-    template<typename X, typename Y>
-    friend auto swap(expected<X, Y>&, expected<X, Y>&) noexcept ->void;
-
-	auto swap(expected& other)  noexcept ->void {
-		std::swap(context_, other.context_);
+	CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected& other)
+        noexcept(detail::is_nothrow_swappable_storage_v<T> && detail::is_nothrow_swappable_storage_v<E>) ->void {
+		base_type::swap(other);
 	}
 
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, T&>>>
-    auto and_then(F&& f) & ->RetTy {
+    constexpr auto and_then(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, E&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), T&>, "type `F` must be able to accept `T&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(value());
         else
             return RetTy(unexpect, error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const T&>>>
-    auto and_then(F&& f) const& ->RetTy {
+    constexpr auto and_then(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const T&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const T&>, "type `F` must be able to accept `const T&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(value());
         else
             return RetTy(unexpect, error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, T&&>>>
-    auto and_then(F&& f) && ->RetTy {
+    constexpr auto and_then(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, T&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, E&&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), T&&>, "type `F` must be able to accept `T&&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(std::move(value()));
         else
             return RetTy(unexpect, std::move(error()));
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const T&&>>>
-    auto and_then(F&& f) const&& ->RetTy {
+    constexpr auto and_then(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const T&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const T&&>, "type `F` must be able to accept `const T&&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(std::move(value()));
         else
             return RetTy(unexpect, std::move(error()));
     }
 
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, E&>>>
-    auto or_else(F&& f) & ->RetTy {
+    constexpr auto or_else(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, E&> && std::is_nothrow_constructible_v<RetTy, in_place_t, T&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), E&>, "type `F` must be able to accept `E&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place, value());
         else
             return std::forward<F>(f)(error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const E&>>>
-    auto or_else(F&& f) const& ->RetTy {
+    constexpr auto or_else(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_constructible_v<RetTy, in_place_t, const T&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const E&>, "type `F` must be able to accept `const E&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place, value());
         else
             return std::forward<F>(f)(error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, E&&>>>
-    auto or_else(F&& f) && ->RetTy {
+    constexpr auto or_else(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_constructible_v<RetTy, in_place_t, T&&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), E&&>, "type `F` must be able to accept `E&&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place, std::move(value()));
         else
             return std::forward<F>(f)(std::move(error()));
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const E&&>>>
-    auto or_else(F&& f) const&& ->RetTy {
+    constexpr auto or_else(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const E&&> && std::is_nothrow_constructible_v<RetTy, in_place_t, const T&&>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const E&&>, "type `F` must be able to accept `const E&&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place, std::move(value()));
         else
             return std::forward<F>(f)(std::move(error()));
     }
 
-    template<typename F, typename RetTy = expected<remove_cvref_t<std::invoke_result_t<F, T&>>, E>>
-    auto transform(F&& f) & ->RetTy {
-        if (has_value())
+    template<typename F, typename RetTy = detail::transform_lvalue_result_t<std::invoke_result_t<F, T&>, E>>
+    constexpr auto transform(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F, T&>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, E&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(value());
         else
             return RetTy(unexpect, error());
     }
-    template<typename F, typename RetTy = expected<remove_cvref_t<std::invoke_result_t<F, const T&>>, E>>
-    auto transform(F&& f) const& ->RetTy {
-        if (has_value())
+    template<typename F, typename RetTy = detail::transform_lvalue_result_t<std::invoke_result_t<F, const T&>, E>>
+    constexpr auto transform(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const T&> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F, const T&>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(value());
         else
             return RetTy(unexpect, error());
     }
     template<typename F, typename RetTy = expected<remove_cvref_t<std::invoke_result_t<F, T&&>>, E>>
-    auto transform(F&& f) && ->RetTy {
-        if (has_value())
+    constexpr auto transform(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, T&&> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F, T&&>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, E&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(std::move(value()));
         else
             return RetTy(unexpect, std::move(error()));
     }
     template<typename F, typename RetTy = expected<remove_cvref_t<std::invoke_result_t<F, const T&&>>, E>>
-    auto transform(F&& f) const&& ->RetTy {
-        if (has_value())
+    constexpr auto transform(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const T&&> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F, const T&&>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)(std::move(value()));
         else
             return RetTy(unexpect, std::move(error()));
     }
 
     template<typename F, typename RetTy = expected<T, remove_cvref_t<std::invoke_result_t<F, E&>>>>
-    auto transform_error(F&& f) & ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, E&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, E&>> &&
+            std::is_nothrow_constructible_v<RetTy, T&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return value();
         else
             return RetTy(unexpect, std::forward<F>(f)(error()));
     }
     template<typename F, typename RetTy = expected<T, remove_cvref_t<std::invoke_result_t<F, const E&>>>>
-    auto transform_error(F&& f) const& ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, const E&>> &&
+            std::is_nothrow_constructible_v<RetTy, const T&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return value();
         else
             return RetTy(unexpect, std::forward<F>(f)(error()));
     }
     template<typename F, typename RetTy = expected<T, remove_cvref_t<std::invoke_result_t<F, E&&>>>>
-    auto transform_error(F&& f) && ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, E&&>> &&
+            std::is_nothrow_constructible_v<RetTy, T&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::move(value());
         else
             return RetTy(unexpect, std::forward<F>(f)(std::move(error())));
     }
     template<typename F, typename RetTy = expected<T, remove_cvref_t<std::invoke_result_t<F, const E&&>>>>
-    auto transform_error(F&& f) const&& ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const E&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, const E&&>> &&
+            std::is_nothrow_constructible_v<RetTy, const T&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::move(value());
         else
             return RetTy(unexpect, std::forward<F>(f)(std::move(error())));
     }
+};
 
-private:
-    std::variant<T, E> context_;
+
+/// @brief: an `expected` referring to a `T` it doesn't own, stored as a `T*` beside the error,
+/// so it is pointer-sized plus the error and never copies the referred object.
+/// like a pointer, assigning a `T&` rebinds the reference instead of assigning through it,
+/// and `const` on the `expected` doesn't propagate to the referred object
+template<typename T, typename E>
+class expected<T&, E> : private detail::expected_base_t<T*, E, detail::reference_niche_traits<T>>, private detail::expected_enable_special_members<T*, E> {
+    static_assert(std::is_object_v<E>, "type `E` must be an object-type");
+    static_assert(!std::is_array_v<E>, "type `E` can't be an array-type");
+    static_assert(!std::is_const_v<E> && !std::is_volatile_v<E>, "cv qualifiers can't be applied to type `E`");
+    static_assert(std::is_move_constructible_v<E>, "type `E` must be move-constructible");
+
+    using base_type = detail::expected_base_t<T*, E, detail::reference_niche_traits<T>>;
+    friend struct detail::expected_layout<T&, E>;
+
+    template<typename U>
+    constexpr static bool is_bindable_v = std::is_lvalue_reference_v<U> && std::is_convertible_v<std::remove_reference_t<U>*, T*> &&
+        !is_template_expected_instance_class_v<remove_cvref_t<U>> && !is_template_unexpected_instance_class_v<remove_cvref_t<U>>;
+public:
+    using value_type = T&;
+    using error_type = E;
+    using unexpected_type = unexpected<E>;
+    template<typename U>
+    using rebind = expected<U, error_type>;
+
+    expected(const expected&) = default;
+    expected(expected&&) = default;
+
+    template<typename U, typename = std::enable_if_t<is_bindable_v<U>>>
+    constexpr expected(U&& u) noexcept : base_type(std::in_place, detail::addressof(u)) {}
+    template<typename U, typename G, typename = std::enable_if_t<
+        std::is_convertible_v<U*, T*> && !std::is_same_v<U, T> && std::is_constructible_v<E, const G&>
+    >>
+    constexpr expected(const expected<U&, G>& other) noexcept(std::is_nothrow_constructible_v<E, const G&>)
+        : base_type(other.has_value() ? base_type(std::in_place, static_cast<T*>(detail::addressof(*other))) : base_type(unexpect, other.error())) {}
+    template<typename G>
+    constexpr expected(const unexpected<G>& e) noexcept(std::is_nothrow_constructible_v<E, const G&>) : expected(unexpect, e.error()) {}
+    template<typename G>
+    constexpr expected(unexpected<G>&& e) noexcept(std::is_nothrow_constructible_v<E, G>) : expected(unexpect, std::move(e.error())) {}
+
+    template<typename U, typename = std::enable_if_t<is_bindable_v<U>>>
+    constexpr explicit expected(std::in_place_t, U&& u) noexcept : base_type(std::in_place, detail::addressof(u)) {}
+
+    template<typename... Args>
+    constexpr explicit expected(unexpect_t, Args&&... args ) noexcept(std::is_nothrow_constructible_v<E, Args...>)
+        : base_type(unexpect, std::forward<Args>(args)...) {}
+    template<typename U, typename... Args>
+    constexpr explicit expected(unexpect_t, std::initializer_list<U> il, Args&&... args )
+        noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<U>&, Args...>)
+        : base_type(unexpect, il, std::forward<Args>(args)...) {}
+
+    ~expected() = default;
+
+    auto operator= (const expected&) ->expected& = default;
+    auto operator= (expected&&) ->expected& = default;
+    template<typename U, typename = std::enable_if_t<is_bindable_v<U>>>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (U&& u) noexcept ->expected& {
+        this->emplace_value(detail::addressof(u));
+        return *this;
+    }
+    template<typename G>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (const unexpected<G>& other) noexcept(std::is_nothrow_constructible_v<E, const G&>) ->expected& {
+        this->emplace_error(other.error());
+        return *this;
+    }
+    template<typename G>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (unexpected<G>&& other ) noexcept(std::is_nothrow_constructible_v<E, G>) ->expected& {
+        this->emplace_error(std::move(other.error()));
+        return *this;
+    }
+
+    /// @brief: rebinds to `u`
+    template<typename U, typename = std::enable_if_t<is_bindable_v<U>>>
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace(U&& u) noexcept ->T& {
+        this->emplace_value(detail::addressof(u));
+        return **this;
+    }
+
+    constexpr auto has_value() const noexcept ->bool {
+        return this->contains_value();
+    }
+    constexpr explicit operator bool() const noexcept {
+        return has_value();
+    }
+
+    constexpr auto error() & noexcept ->E& {
+        /// @warning: if result of `has_value` is true, the behavior is undefined
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return this->get_error();
+    }
+    constexpr auto error() && noexcept ->E&& {
+        /// @warning: if result of `has_value` is true, the behavior is undefined
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return std::move(this->get_error());
+    }
+    constexpr auto error() const& noexcept ->const E& {
+        /// @warning: if result of `has_value` is true, the behavior is undefined
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return this->get_error();
+    }
+    constexpr auto error() const&& noexcept ->const E&& {
+        /// @warning: if result of `has_value` is true, the behavior is undefined
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return std::move(this->get_error());
+    }
+
+    constexpr auto value() const& ->T& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(error());
+        return *this->get_value();
+    }
+    constexpr auto value() && ->T& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(std::move(error()));
+        return *this->get_value();
+    }
+    template<typename U>
+    constexpr auto value_or(U&& default_value) const ->std::remove_cv_t<T> {
+        static_assert(std::is_convertible_v<U, std::remove_cv_t<T>>, "there is no conversion from `U` to `T`");
+        if (CCAT_EXPECTED_LIKELY(has_value())) return *this->get_value();
+        return std::forward<U>(default_value);
+    }
+    constexpr auto operator*() const noexcept ->T& {
+        /// @warning: if result of `has_value` is false, the behavior is undefined
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected` holding an error");
+        return *this->get_value();
+    }
+    constexpr auto operator->() const noexcept ->T* {
+        /// @warning: if result of `has_value` is false, the behavior is undefined
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator->` called on an `expected` holding an error");
+        return this->get_value();
+    }
+
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected& other) noexcept(detail::is_nothrow_swappable_storage_v<E>) ->void {
+        base_type::swap(other);
+    }
+
+    template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, T&>>>
+    constexpr auto and_then(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&>)
+        ->RetTy {
+        static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), T&>, "type `F` must be able to accept `T&`");
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return std::forward<F>(f)(**this);
+        else
+            return RetTy(unexpect, error());
+    }
+    template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, T&>>>
+    constexpr auto and_then(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, E&&>)
+        ->RetTy {
+        static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), T&>, "type `F` must be able to accept `T&`");
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return std::forward<F>(f)(**this);
+        else
+            return RetTy(unexpect, std::move(error()));
+    }
+
+    template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, E&>>>
+    constexpr auto or_else(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, E&> && std::is_nothrow_constructible_v<RetTy, in_place_t, T&>)
+        ->RetTy {
+        static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), E&>, "type `F` must be able to accept `E&`");
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return std::forward<F>(f)(error());
+    }
+    template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const E&>>>
+    constexpr auto or_else(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_constructible_v<RetTy, in_place_t, T&>)
+        ->RetTy {
+        static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const E&>, "type `F` must be able to accept `const E&`");
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return std::forward<F>(f)(error());
+    }
+    template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, E&&>>>
+    constexpr auto or_else(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_constructible_v<RetTy, in_place_t, T&>)
+        ->RetTy {
+        static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), E&&>, "type `F` must be able to accept `E&&`");
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return std::forward<F>(f)(std::move(error()));
+    }
+    template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const E&&>>>
+    constexpr auto or_else(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const E&&> && std::is_nothrow_constructible_v<RetTy, in_place_t, T&>)
+        ->RetTy {
+        static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const E&&>, "type `F` must be able to accept `const E&&`");
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return std::forward<F>(f)(std::move(error()));
+    }
+
+    /// @note: the referred object outlives the `expected`, so an lvalue reference returned by `f` is kept as an `expected<U&, E>`
+    template<typename F, typename RetTy = detail::transform_lvalue_result_t<std::invoke_result_t<F, T&>, E>>
+    constexpr auto transform(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F, T&>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return std::forward<F>(f)(**this);
+        else
+            return RetTy(unexpect, error());
+    }
+    template<typename F, typename RetTy = detail::transform_lvalue_result_t<std::invoke_result_t<F, T&>, E>>
+    constexpr auto transform(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F, T&>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, E&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return std::forward<F>(f)(**this);
+        else
+            return RetTy(unexpect, std::move(error()));
+    }
+
+    template<typename F, typename RetTy = expected<T&, remove_cvref_t<std::invoke_result_t<F, E&>>>>
+    constexpr auto transform_error(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, E&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, E&>>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return RetTy(unexpect, std::forward<F>(f)(error()));
+    }
+    template<typename F, typename RetTy = expected<T&, remove_cvref_t<std::invoke_result_t<F, const E&>>>>
+    constexpr auto transform_error(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, const E&>>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return RetTy(unexpect, std::forward<F>(f)(error()));
+    }
+    template<typename F, typename RetTy = expected<T&, remove_cvref_t<std::invoke_result_t<F, E&&>>>>
+    constexpr auto transform_error(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, E&&>>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return RetTy(unexpect, std::forward<F>(f)(std::move(error())));
+    }
+    template<typename F, typename RetTy = expected<T&, remove_cvref_t<std::invoke_result_t<F, const E&&>>>>
+    constexpr auto transform_error(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const E&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, const E&&>>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
+            return RetTy(std::in_place, **this);
+        else
+            return RetTy(unexpect, std::forward<F>(f)(std::move(error())));
+    }
 };
 
 
 template<typename E>
-class expected<void, E> {
+class expected<void, E> : private detail::expected_base_t<detail::void_value, E>, private detail::expected_enable_special_members<detail::void_value, E> {
     static_assert(std::is_object_v<E>, "type `E` must be an object-type");
     static_assert(!std::is_array_v<E>, "type `E` can't be an array-type");
     static_assert(!std::is_const_v<E> && !std::is_volatile_v<E>, "cv qualifiers can't be applied to type `E`");
     static_assert(std::is_move_constructible_v<E>, "type `E` must be move-constructible");
+
+    using base_type = detail::expected_base_t<detail::void_value, E>;
+    friend struct detail::expected_layout<void, E>;
 public:
     using value_type = void;
     using error_type = E;
@@ -398,166 +1349,346 @@ public:
     expected() = default;
     expected(const expected&) = default;
     expected(expected&&) = default;
-    explicit expected(std::in_place_t) : context_(std::nullopt) {}
+    constexpr explicit expected(std::in_place_t) noexcept : base_type(std::in_place) {}
     template<typename... Args>
-    expected(unexpect_t, Args... args) : context_(std::forward<Args>(args)...) {};
+    constexpr expected(unexpect_t, Args... args) noexcept(std::is_nothrow_constructible_v<E, Args...>) : base_type(unexpect, std::forward<Args>(args)...) {};
     template<typename U, typename... Args>
-    expected(unexpect_t, std::initializer_list<U> il, Args... args) : context_(il, std::forward<Args>(args)...) {};
+    constexpr expected(unexpect_t, std::initializer_list<U> il, Args... args)
+        noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<U>&, Args...>) : base_type(unexpect, il, std::forward<Args>(args)...) {};
 
     ~expected() = default;
 
     auto operator= (const expected&) ->expected& = default;
     auto operator= (expected&&) ->expected& = default;
     template<typename G>
-    auto operator= (const unexpected<G>& other) ->expected& {
-        context_.emplace(other.error());
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (const unexpected<G>& other) noexcept(std::is_nothrow_constructible_v<E, const G&>) ->expected& {
+        this->emplace_error(other.error());
         return *this;
     }
     template<typename G>
-    auto operator= (unexpected<G>&& other ) ->expected& {
-        context_.emplace(std::move(other.error()));
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto operator= (unexpected<G>&& other ) noexcept(std::is_nothrow_constructible_v<E, G>) ->expected& {
+        this->emplace_error(std::move(other.error()));
         return *this;
     }
 
-    auto emplace() noexcept ->void {
-        context_ = std::nullopt;
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto emplace() noexcept ->void {
+        this->emplace_value();
     }
 
-    auto value() ->void {
-        if (!has_value()) throw bad_expected_access("ccat::bad_expected_access: this expect has no value");
+    constexpr auto value() ->void {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(error());
+    }
+    constexpr auto value_or() ->void {}
+    constexpr auto operator*() const noexcept ->void {
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected` holding an error");
     }
-    auto value_or() ->void {}
-    auto operator*() ->void {}
 
-    auto error() & noexcept ->E& {
+    constexpr auto error() & noexcept ->E& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return *context_;
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return this->get_error();
     }
-    auto error() && noexcept ->E&& {
+    constexpr auto error() && noexcept ->E&& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return std::move(*context_);
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return std::move(this->get_error());
     }
-    auto error() const& noexcept ->const E& {
+    constexpr auto error() const& noexcept ->const E& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return *context_;
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return this->get_error();
     }
-    auto error() const&& noexcept ->const E&& {
+    constexpr auto error() const&& noexcept ->const E&& {
         /// @warning: if result of `has_value` is true, the behavior is undefined
-        return std::move(*context_);
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected` holding a value");
+        return std::move(this->get_error());
     }
 
-    auto has_value() const noexcept ->bool {
-        return !context_.has_value();
+    constexpr auto has_value() const noexcept ->bool {
+        return this->contains_value();
     }
-    explicit operator bool() const noexcept {
+    constexpr explicit operator bool() const noexcept {
         return has_value();
     }
 
-    template<typename X, typename Y>
-    friend auto swap(expected<X, Y>&, expected<X, Y>&) noexcept ->void;
     
-    auto swap(expected& other) noexcept ->void {
-        return std::swap(context_, other.context_);
+    CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected& other) noexcept(detail::is_nothrow_swappable_storage_v<E>) ->void {
+        base_type::swap(other);
     }
 
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F>>>
-    auto and_then(F&& f) const& ->RetTy {
-        if (has_value())
+    constexpr auto and_then(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)();
         else
             return RetTy(unexpect, error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F>>>
-    auto and_then(F&& f) const&& ->RetTy {
-        if (has_value())
+    constexpr auto and_then(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)();
         else
             return RetTy(unexpect, std::move(error()));
     }
 
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, E&>>>
-    auto or_else(F&& f) & ->RetTy {
+    constexpr auto or_else(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, E&> && std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), E&>, "type `F` must be able to accept `E&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place);
         else
             return std::forward<F>(f)(error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const E&>>>
-    auto or_else(F&& f) const& ->RetTy {
+    constexpr auto or_else(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const E&>, "type `F` must be able to accept `const E&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place);
         else
             return std::forward<F>(f)(error());
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, E&&>>>
-    auto or_else(F&& f) && ->RetTy {
+    constexpr auto or_else(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), E&&>, "type `F` must be able to accept `E&&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place);
         else
             return std::forward<F>(f)(std::move(error()));
     }
     template<typename F, typename RetTy = remove_cvref_t<std::invoke_result_t<F, const E&&>>>
-    auto or_else(F&& f) const&& ->RetTy {
+    constexpr auto or_else(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const E&&> && std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
         static_assert(std::is_invocable_v<decltype(std::forward<F>(f)), const E&&>, "type `F` must be able to accept `const E&&`");
-        if (has_value())
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(std::in_place);
         else
             return std::forward<F>(f)(std::move(error()));
     }
 
     template<typename F, typename RetTy = expected<remove_cvref_t<std::invoke_result_t<F>>, E>>
-    auto transform(F&& f) const& ->RetTy {
-        if (has_value())
+    constexpr auto transform(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)();
         else
             return RetTy(unexpect, error());
     }
     template<typename F, typename RetTy = expected<remove_cvref_t<std::invoke_result_t<F>>, E>>
-    auto transform(F&& f) const&& ->RetTy {
-        if (has_value())
+    constexpr auto transform(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_constructible_v<RetTy, std::invoke_result_t<F>> &&
+            std::is_nothrow_constructible_v<RetTy, unexpect_t, const E&&>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return std::forward<F>(f)();
         else
             return RetTy(unexpect, std::move(error()));
     }
 
     template<typename F, typename RetTy = expected<void, remove_cvref_t<std::invoke_result_t<F, E&>>>>
-    auto transform_error(F&& f) & ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) &
+        noexcept(std::is_nothrow_invocable_v<F, E&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, E&>> &&
+            std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(in_place);
         else
             return RetTy(unexpect, std::forward<F>(f)(error()));
     }
     template<typename F, typename RetTy = expected<void, remove_cvref_t<std::invoke_result_t<F, const E&>>>>
-    auto transform_error(F&& f) const& ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) const&
+        noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, const E&>> &&
+            std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(in_place);
         else
             return RetTy(unexpect, std::forward<F>(f)(error()));
     }
     template<typename F, typename RetTy = expected<void, remove_cvref_t<std::invoke_result_t<F, E&&>>>>
-    auto transform_error(F&& f) && ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) &&
+        noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, E&&>> &&
+            std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(in_place);
         else
             return RetTy(unexpect, std::forward<F>(f)(std::move(error())));
     }
     template<typename F, typename RetTy = expected<void, remove_cvref_t<std::invoke_result_t<F, const E&&>>>>
-    auto transform_error(F&& f) const&& ->RetTy {
-        if (has_value())
+    constexpr auto transform_error(F&& f) const&&
+        noexcept(std::is_nothrow_invocable_v<F, const E&&> && std::is_nothrow_constructible_v<RetTy, unexpect_t, std::invoke_result_t<F, const E&&>> &&
+            std::is_nothrow_constructible_v<RetTy, in_place_t>)
+        ->RetTy {
+        if (CCAT_EXPECTED_LIKELY(has_value()))
             return RetTy(in_place);
         else
             return RetTy(unexpect, std::forward<F>(f)(std::move(error())));
     }
-private:
-	std::optional<E> context_;
 };
 
 template<typename T, typename E>
-auto swap(expected<T, E>& lhs, expected<T, E>& rhs ) noexcept ->void{
-	std::swap(lhs.context_, rhs.context_);
+CCAT_EXPECTED_CONSTEXPR_CXX20 auto swap(expected<T, E>& lhs, expected<T, E>& rhs ) noexcept(noexcept(lhs.swap(rhs))) ->void{
+	lhs.swap(rhs);
+}
+
+namespace detail {
+
+/// @brief: where the discriminator of an `expected<T, E>` lives, for code scanning arrays of them byte by byte.
+/// `has_flag_byte` holds when it is a trivially copyable union plus a one-byte `bool` (`0` while holding an error)
+template<typename T, typename E>
+struct expected_layout {
+    using stored_type = std::conditional_t<std::is_void_v<T>, void_value,
+        std::conditional_t<std::is_lvalue_reference_v<T>, std::remove_reference_t<T>*, T>>;
+    using niche_traits_type = std::conditional_t<std::is_lvalue_reference_v<T>,
+        reference_niche_traits<std::remove_reference_t<T>>, default_niche_traits<stored_type, E>>;
+    constexpr static bool has_flag_byte = !is_niche_storage_v<stored_type, E, niche_traits_type> &&
+        std::is_trivially_copyable_v<expected<T, E>> && sizeof(bool) == 1;
+
+    static auto flag_offset(const expected<T, E>& x) noexcept ->std::size_t {
+        const auto& data = static_cast<const expected_storage_data<stored_type, E>&>(x);
+        return static_cast<std::size_t>(
+            reinterpret_cast<const unsigned char*>(detail::addressof(data.has_value_)) - reinterpret_cast<const unsigned char*>(detail::addressof(x))
+        );
+    }
+};
+
+}
+
+/// @brief: pipeline step calling `f(value)`, which returns an `expected` with the same error type
+template<typename F>
+struct then_step {
+    F f;
+};
+
+/// @brief: pipeline step calling `f(value)`, which returns the next value
+template<typename F>
+struct map_step {
+    F f;
+};
+
+template<typename F>
+constexpr auto then(F&& f) ->then_step<std::decay_t<F>> {
+    return {std::forward<F>(f)};
+}
+
+template<typename F>
+constexpr auto map(F&& f) ->map_step<std::decay_t<F>> {
+    return {std::forward<F>(f)};
+}
+
+namespace detail {
+
+/// @brief: what a step `F` returns for the value `V`, which it is called without when `V` is `void`
+template<typename F, typename V>
+struct pipeline_step_result {
+    using type = std::invoke_result_t<F&, V>;
+};
+template<typename F>
+struct pipeline_step_result<F, void> {
+    using type = std::invoke_result_t<F&>;
+};
+template<typename F, typename V>
+using pipeline_step_result_t = typename pipeline_step_result<F, V>::type;
+
+template<typename V, typename... Steps>
+struct pipeline_value {
+    using type = remove_cvref_t<V>;
+};
+template<typename V, typename F, typename... Rest>
+struct pipeline_value<V, then_step<F>, Rest...> :
+    pipeline_value<typename remove_cvref_t<pipeline_step_result_t<F, V>>::value_type, Rest...> {};
+template<typename V, typename F, typename... Rest>
+struct pipeline_value<V, map_step<F>, Rest...> :
+    pipeline_value<pipeline_step_result_t<F, V>, Rest...> {};
+
+}
+
+/// @brief: a lazy `and_then`/`transform` chain fused into one short-circuiting call,
+/// so an error is moved once into the result instead of being rebuilt at every step.
+/// e.g. `expected<Ast, Error> ast = ccat::pipe(read(path)) | ccat::then(lex) | ccat::map(trim) | ccat::then(parse);`.
+/// steps of `expected<void, E>`, and `map` steps returning `void`, call the next step without arguments
+/// @note: an lvalue source is referred to until the pipeline runs, so it must outlive the pipeline; an rvalue source is
+/// moved into the pipeline, and along with it at every `|`, so a pipeline may be stored and run later
+template<typename X, typename... Steps>
+class pipeline {
+    using source_type = remove_cvref_t<X>;
+    static_assert(is_template_expected_instance_class_v<source_type>, "type `X` must be an `expected`");
+public:
+    using error_type = typename source_type::error_type;
+    using value_type = typename detail::pipeline_value<decltype(*std::declval<X>()), Steps...>::type;
+    using result_type = expected<value_type, error_type>;
+
+    constexpr pipeline(X&& source, std::tuple<Steps...> steps) noexcept(std::is_nothrow_move_constructible_v<std::tuple<Steps...>>)
+        : source_(std::forward<X>(source)), steps_(std::move(steps)) {}
+
+    template<typename F>
+    constexpr auto operator| (then_step<F> step) && ->pipeline<X, Steps..., then_step<F>> {
+        return {std::forward<X>(source_), std::tuple_cat(std::move(steps_), std::make_tuple(std::move(step)))};
+    }
+    template<typename F>
+    constexpr auto operator| (map_step<F> step) && ->pipeline<X, Steps..., map_step<F>> {
+        return {std::forward<X>(source_), std::tuple_cat(std::move(steps_), std::make_tuple(std::move(step)))};
+    }
+
+    constexpr auto run() && ->result_type {
+        if (CCAT_EXPECTED_UNLIKELY(!source_.has_value()))
+            return result_type(unexpect, std::forward<X>(source_).error());
+        if constexpr (std::is_void_v<typename source_type::value_type>)
+            return apply<0>();
+        else
+            return apply<0>(*std::forward<X>(source_));
+    }
+    constexpr operator result_type() && {
+        return std::move(*this).run();
+    }
+private:
+    template<std::size_t I, typename... V>
+    constexpr auto apply(V&&... v) ->result_type {
+        if constexpr (I == sizeof...(Steps))
+            return result_type(std::in_place, std::forward<V>(v)...);
+        else if constexpr (is_then_step<std::tuple_element_t<I, std::tuple<Steps...>>>::value) {
+            auto r = std::get<I>(steps_).f(std::forward<V>(v)...);
+            static_assert(std::is_same_v<typename decltype(r)::error_type, error_type>, "every `then` step must return the same error type");
+            if (CCAT_EXPECTED_UNLIKELY(!r.has_value()))
+                return result_type(unexpect, std::move(r).error());
+            if constexpr (std::is_void_v<typename decltype(r)::value_type>)
+                return apply<I + 1>();
+            else
+                return apply<I + 1>(*std::move(r));
+        }
+        else if constexpr (std::is_void_v<decltype(std::get<I>(steps_).f(std::forward<V>(v)...))>) {
+            std::get<I>(steps_).f(std::forward<V>(v)...);
+            return apply<I + 1>();
+        }
+        else
+            return apply<I + 1>(std::get<I>(steps_).f(std::forward<V>(v)...));
+    }
+
+    template<typename Step>
+    struct is_then_step : std::false_type {};
+    template<typename F>
+    struct is_then_step<then_step<F>> : std::true_type {};
+
+    std::conditional_t<std::is_lvalue_reference_v<X>, X, source_type> source_;
+    std::tuple<Steps...> steps_;
+};
+
+template<typename X>
+constexpr auto pipe(X&& source) ->pipeline<X> {
+    return {std::forward<X>(source), std::tuple<>{}};
 }
 
 }
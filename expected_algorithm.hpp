@@ -0,0 +1,336 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include "expected_vector.hpp"
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CCAT_EXPECTED_SIMD_WIDTH 32
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#include <emmintrin.h>
+#define CCAT_EXPECTED_SIMD_WIDTH 16
+#else
+#define CCAT_EXPECTED_SIMD_WIDTH 0
+#endif
+
+namespace ccat {
+
+namespace detail {
+
+#if CCAT_EXPECTED_SIMD_WIDTH
+/// @return: bit `k` is set if byte `k` of the `CCAT_EXPECTED_SIMD_WIDTH` bytes at `p` is zero
+inline auto zero_byte_mask(const unsigned char* p) noexcept ->std::uint32_t {
+#if CCAT_EXPECTED_SIMD_WIDTH == 32
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+#else
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())));
+#endif
+}
+
+/// @return: the number of zero bytes at `p` among the `blocks * CCAT_EXPECTED_SIMD_WIDTH` bytes that follow,
+/// only counting the positions whose byte of the block `select` is `1`. the counts are summed byte-wise
+/// in a vector register, which can't overflow for 255 blocks
+inline auto count_zero_bytes(const unsigned char* p, std::size_t blocks, const unsigned char* select) noexcept ->std::size_t {
+    std::size_t count = 0;
+    alignas(32) std::uint64_t lanes[CCAT_EXPECTED_SIMD_WIDTH / 8];
+    while (blocks) {
+        const std::size_t chunk = blocks < 255 ? blocks : 255;
+        blocks -= chunk;
+#if CCAT_EXPECTED_SIMD_WIDTH == 32
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(select));
+        __m256i sums = zero;
+        for (std::size_t k = 0; k < chunk; ++k, p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            sums = _mm256_add_epi8(sums, _mm256_and_si256(_mm256_cmpeq_epi8(v, zero), mask));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_sad_epu8(sums, zero));
+#else
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(select));
+        __m128i sums = zero;
+        for (std::size_t k = 0; k < chunk; ++k, p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            sums = _mm_add_epi8(sums, _mm_and_si128(_mm_cmpeq_epi8(v, zero), mask));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_sad_epu8(sums, zero));
+#endif
+        for (const auto lane : lanes) count += static_cast<std::size_t>(lane);
+    }
+    return count;
+}
+#endif
+
+/// @brief: an array of `n` objects of `stride` bytes, each with a `bool` flag at byte `offset`
+struct flag_array {
+    const unsigned char* base;
+    std::size_t n;
+    std::size_t stride;
+    std::size_t offset;
+
+    auto flag(std::size_t i) const noexcept ->bool {
+        return base[i * stride + offset] != 0;
+    }
+    /// @brief: whole vector blocks can be scanned when the stride divides the vector width
+    auto vectorizable() const noexcept ->bool {
+        return CCAT_EXPECTED_SIMD_WIDTH != 0 && stride <= CCAT_EXPECTED_SIMD_WIDTH && CCAT_EXPECTED_SIMD_WIDTH % stride == 0;
+    }
+    /// @return: bit set at the flag byte of every object in a block
+    auto block_pattern() const noexcept ->std::uint32_t {
+        std::uint32_t m = 0;
+        for (std::size_t k = offset; k < CCAT_EXPECTED_SIMD_WIDTH; k += stride) m |= std::uint32_t{1} << k;
+        return m;
+    }
+
+    auto count_zero() const noexcept ->std::size_t {
+        std::size_t count = 0, i = 0;
+#if CCAT_EXPECTED_SIMD_WIDTH
+        if (vectorizable()) {
+            unsigned char select[CCAT_EXPECTED_SIMD_WIDTH] = {};
+            for (std::size_t k = offset; k < CCAT_EXPECTED_SIMD_WIDTH; k += stride) select[k] = 1;
+            const auto per_block = CCAT_EXPECTED_SIMD_WIDTH / stride;
+            const auto blocks = n / per_block;
+            count = count_zero_bytes(base, blocks, select);
+            i = blocks * per_block;
+        }
+#endif
+        for (; i < n; ++i) count += !flag(i);
+        return count;
+    }
+    /// @return: the index of the first zero flag, or `n` if there is none
+    auto find_zero() const noexcept ->std::size_t {
+        std::size_t i = 0;
+#if CCAT_EXPECTED_SIMD_WIDTH
+        if (vectorizable()) {
+            const auto pattern = block_pattern();
+            const auto per_block = CCAT_EXPECTED_SIMD_WIDTH / stride;
+            for (; i + per_block <= n; i += per_block) {
+                if (const auto m = zero_byte_mask(base + i * stride) & pattern)
+                    return i + static_cast<std::size_t>(countr_zero(m)) / stride;
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            if (!flag(i)) return i;
+        }
+        return n;
+    }
+    /// @brief: calls `on_value(i)` or `on_error(i)` for every object in order, stopping after an `on_error` that
+    /// returns `false`. a block without zero flag calls `on_value` for each of its objects without testing them one by one
+    /// @return: the index of the object it stopped at, or `n`
+    template<typename OnValue, typename OnError>
+    auto for_each(OnValue&& on_value, OnError&& on_error) const ->std::size_t {
+        std::size_t i = 0;
+#if CCAT_EXPECTED_SIMD_WIDTH
+        if (vectorizable()) {
+            const auto pattern = block_pattern();
+            const auto per_block = CCAT_EXPECTED_SIMD_WIDTH / stride;
+            for (; i + per_block <= n; i += per_block) {
+                const auto m = zero_byte_mask(base + i * stride) & pattern;
+                if (CCAT_EXPECTED_LIKELY(m == 0)) {
+                    for (std::size_t k = 0; k < per_block; ++k) on_value(i + k);
+                    continue;
+                }
+                for (std::size_t k = 0; k < per_block; ++k) {
+                    if (!(m >> (offset + k * stride) & 1)) on_value(i + k);
+                    else if (!on_error(i + k)) return i + k;
+                }
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            if (flag(i)) on_value(i);
+            else if (!on_error(i)) return i;
+        }
+        return n;
+    }
+};
+
+template<typename It, typename = void>
+struct is_flag_scannable : std::false_type {};
+template<typename T, typename E>
+struct is_flag_scannable<const expected<T, E>*> : std::bool_constant<expected_layout<T, E>::has_flag_byte> {};
+template<typename T, typename E>
+struct is_flag_scannable<expected<T, E>*> : std::bool_constant<expected_layout<T, E>::has_flag_byte> {};
+
+template<typename T, typename E>
+auto make_flag_array(const expected<T, E>* first, const expected<T, E>* last) noexcept ->flag_array {
+    const auto n = static_cast<std::size_t>(last - first);
+    return {
+        reinterpret_cast<const unsigned char*>(first), n, sizeof(expected<T, E>),
+        n ? expected_layout<T, E>::flag_offset(*first) : 0
+    };
+}
+
+template<typename Range, typename = void>
+struct is_contiguous_range : std::false_type {};
+template<typename Range>
+struct is_contiguous_range<Range, std::void_t<
+    decltype(std::data(std::declval<const Range&>())), decltype(std::size(std::declval<const Range&>()))
+>> : std::true_type {};
+
+/// @brief: what `collect` stores for a value of type `V`: the referred objects of `expected<T&, E>` are kept as
+/// `std::reference_wrapper<T>`, since there are no vectors of references
+template<typename V>
+using collect_element_t = std::conditional_t<std::is_lvalue_reference_v<V>, std::reference_wrapper<std::remove_reference_t<V>>, V>;
+
+/// @brief: `x.transform(f)` for an `x` already known to hold a value
+template<typename X, typename F>
+auto transform_value(const X& x, F& f) ->decltype(x.transform(f)) {
+    if constexpr (std::is_void_v<typename X::value_type>)
+        return f();
+    else
+        return f(*x);
+}
+
+template<typename Range>
+auto range_begin(const Range& r) {
+    if constexpr (is_contiguous_range<Range>::value)
+        return std::data(r);
+    else
+        return std::begin(r);
+}
+template<typename Range>
+auto range_end(const Range& r) {
+    if constexpr (is_contiguous_range<Range>::value)
+        return std::data(r) + std::size(r);
+    else
+        return std::end(r);
+}
+
+}
+
+/// @brief: the number of elements in `[first, last)` that hold an error.
+/// pointers into arrays of trivially copyable `expected` are scanned a vector register at a time
+template<typename InputIt>
+auto count_failures(InputIt first, InputIt last) ->std::size_t {
+    if constexpr (detail::is_flag_scannable<InputIt>::value)
+        return detail::make_flag_array(first, last).count_zero();
+    else {
+        std::size_t count = 0;
+        for (; first != last; ++first) count += !first->has_value();
+        return count;
+    }
+}
+template<typename Range>
+auto count_failures(const Range& results) ->std::size_t {
+    return count_failures(detail::range_begin(results), detail::range_end(results));
+}
+template<typename T, typename E>
+auto count_failures(const expected_vector<T, E>& results) noexcept ->std::size_t {
+    return results.count_errors();
+}
+
+/// @return: the first element in `[first, last)` that holds an error, or `last`
+template<typename InputIt>
+auto find_failure(InputIt first, InputIt last) ->InputIt {
+    if constexpr (detail::is_flag_scannable<InputIt>::value)
+        return first + detail::make_flag_array(first, last).find_zero();
+    else {
+        for (; first != last; ++first) {
+            if (!first->has_value()) break;
+        }
+        return first;
+    }
+}
+
+template<typename InputIt>
+auto all_of_value(InputIt first, InputIt last) ->bool {
+    return find_failure(first, last) == last;
+}
+template<typename Range>
+auto all_of_value(const Range& results) ->bool {
+    return all_of_value(detail::range_begin(results), detail::range_end(results));
+}
+template<typename T, typename E>
+auto all_of_value(const expected_vector<T, E>& results) noexcept ->bool {
+    return results.all_values();
+}
+
+/// @return: every value in `[first, last)`, or a copy of the first error.
+/// the values of `expected<T&, E>` are collected as `std::reference_wrapper<T>`
+template<typename InputIt,
+    typename X = remove_cvref_t<typename std::iterator_traits<InputIt>::value_type>,
+    typename RetTy = expected<std::vector<detail::collect_element_t<typename X::value_type>>, typename X::error_type>>
+auto collect(InputIt first, InputIt last) ->RetTy {
+    static_assert(is_template_expected_instance_class_v<X>, "type `InputIt` must iterate over `expected`");
+    static_assert(!std::is_void_v<typename X::value_type>, "there are no values to collect from `expected<void, E>`, see `find_failure`");
+    std::vector<detail::collect_element_t<typename X::value_type>> values;
+    if constexpr (detail::is_flag_scannable<InputIt>::value) {
+        const auto n = static_cast<std::size_t>(last - first);
+        values.reserve(n);
+        const auto failure = detail::make_flag_array(first, last).for_each(
+            [&](std::size_t i) { values.push_back(*first[i]); },
+            [](std::size_t) { return false; }
+        );
+        if (failure != n) return RetTy(unexpect, first[failure].error());
+    }
+    else {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            values.reserve(static_cast<std::size_t>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            if (!first->has_value()) return RetTy(unexpect, first->error());
+            values.push_back(**first);
+        }
+    }
+    return RetTy(std::in_place, std::move(values));
+}
+template<typename Range>
+auto collect(const Range& results) {
+    return collect(detail::range_begin(results), detail::range_end(results));
+}
+
+/// @brief: copies the values of `[first, last)` to `values_out` and the errors to `errors_out`, keeping their order.
+/// arrays of trivially copyable `expected` are tested a vector register at a time, and the values of a register
+/// without error are copied without testing each of them
+/// @return: the ends of both output ranges
+template<typename InputIt, typename ValueOut, typename ErrorOut>
+auto partition_results(InputIt first, InputIt last, ValueOut values_out, ErrorOut errors_out) ->std::pair<ValueOut, ErrorOut> {
+    if constexpr (detail::is_flag_scannable<InputIt>::value) {
+        detail::make_flag_array(first, last).for_each(
+            [&](std::size_t i) { *values_out++ = *first[i]; },
+            [&](std::size_t i) {
+                *errors_out++ = first[i].error();
+                return true;
+            }
+        );
+    }
+    else {
+        for (; first != last; ++first) {
+            if (first->has_value())
+                *values_out++ = **first;
+            else
+                *errors_out++ = first->error();
+        }
+    }
+    return {values_out, errors_out};
+}
+
+/// @brief: writes `x.transform(f)` for every `x` in `[first, last)` to `out`.
+/// arrays of trivially copyable `expected` are scanned like in `partition_results`
+template<typename InputIt, typename OutputIt, typename F>
+auto transform_all(InputIt first, InputIt last, OutputIt out, F f) ->OutputIt {
+    if constexpr (detail::is_flag_scannable<InputIt>::value) {
+        detail::make_flag_array(first, last).for_each(
+            [&](std::size_t i) { *out++ = detail::transform_value(first[i], f); },
+            [&](std::size_t i) {
+                *out++ = first[i].transform(f);
+                return true;
+            }
+        );
+    }
+    else {
+        for (; first != last; ++first) *out++ = first->transform(f);
+    }
+    return out;
+}
+
+}
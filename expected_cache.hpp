@@ -0,0 +1,319 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace ccat {
+
+struct cache_options {
+    /// @brief: entries kept over all shards, the least recently hit ones are evicted first (CLOCK)
+    std::size_t capacity = 4096;
+    std::chrono::steady_clock::duration value_ttl = std::chrono::steady_clock::duration::max();
+    /// @brief: how long an error is served from the cache, zero disables negative caching
+    std::chrono::steady_clock::duration error_ttl = std::chrono::seconds(1);
+    std::size_t shards = 16;
+};
+
+struct cache_stats {
+    std::uint64_t hits;
+    /// @brief: hits that returned a cached error, not included in `hits`
+    std::uint64_t negative_hits;
+    std::uint64_t misses;
+    /// @brief: misses that waited for a computation already running for the same key instead of starting their own
+    std::uint64_t coalesced;
+    std::uint64_t evictions;
+};
+
+/// @brief: a concurrent cache of the results, values and errors alike, of a function returning `expected<T, E>`.
+/// keys are spread over shards, each a fixed open-addressing table behind a reader-writer lock, so hits only
+/// take a shared lock on one shard. concurrent misses on the same key run the computation once
+template<typename K, typename T, typename E, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class expected_cache {
+    static_assert(std::is_copy_constructible_v<T> && std::is_copy_constructible_v<E>, "types `T` and `E` must be copy-constructible to be cached");
+
+    using clock = std::chrono::steady_clock;
+    using result_type = expected<T, E>;
+
+    /// @brief: a computation in flight, which later misses on the same key wait for
+    struct pending {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::optional<result_type> result;
+        std::exception_ptr exception;
+    };
+
+    struct slot {
+        std::optional<K> key;
+        std::size_t hash = 0;
+        std::optional<result_type> result;
+        clock::time_point expires;
+        std::shared_ptr<pending> inflight;
+        /// @note: set by readers under the shared lock, cleared by the eviction hand
+        std::atomic<bool> referenced{false};
+
+        auto reset() noexcept ->void {
+            key.reset();
+            result.reset();
+            inflight.reset();
+            referenced.store(false, std::memory_order_relaxed);
+        }
+        auto take(slot& other) ->void {
+            key = std::move(other.key);
+            hash = other.hash;
+            result = std::move(other.result);
+            expires = other.expires;
+            inflight = std::move(other.inflight);
+            referenced.store(other.referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            other.reset();
+        }
+    };
+
+    struct alignas(64) shard {
+        mutable std::shared_mutex mutex;
+        std::vector<slot> slots;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+        std::size_t hand = 0;
+        unsigned shift = 0;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> negative_hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> coalesced{0};
+        std::atomic<std::uint64_t> evictions{0};
+    };
+public:
+    explicit expected_cache(cache_options options = {}, Hash hash = Hash(), KeyEqual equal = KeyEqual()) :
+        options_(options), hash_(std::move(hash)), equal_(std::move(equal)), shards_(options.shards ? options.shards : 1) {
+        const auto per_shard = (options_.capacity + shards_.size() - 1) / shards_.size();
+        std::size_t slots = 2;
+        unsigned bits = 1;
+        for (; slots < per_shard * 2; slots *= 2) ++bits;
+        for (auto& s : shards_) {
+            s.slots = std::vector<slot>(slots);
+            s.capacity = per_shard ? per_shard : 1;
+            s.shift = 64 - bits;
+        }
+    }
+    expected_cache(const expected_cache&) = delete;
+    auto operator= (const expected_cache&) ->expected_cache& = delete;
+
+    /// @return: the cached result for `key`, or `f(key)` after caching it.
+    /// an exception thrown by `f` reaches every caller waiting on that computation, and nothing is cached
+    template<typename F>
+    auto get_or_compute(const K& key, F&& f) ->result_type {
+        const auto h = hash_(key);
+        auto& s = shards_[h % shards_.size()];
+        std::shared_ptr<pending> wait_for;
+        {
+            std::shared_lock<std::shared_mutex> lock(s.mutex);
+            if (auto* e = find(s, key, h)) {
+                if (e->result && clock::now() < e->expires) return hit(s, *e);
+                wait_for = e->inflight;
+            }
+        }
+        if (wait_for) return join(s, *wait_for);
+
+        auto job = std::make_shared<pending>();
+        {
+            std::unique_lock<std::shared_mutex> lock(s.mutex);
+            auto* e = find(s, key, h);
+            if (e && e->result && clock::now() < e->expires) return hit(s, *e);
+            if (e && e->inflight) {
+                wait_for = e->inflight;
+                lock.unlock();
+                return join(s, *wait_for);
+            }
+            if (!e) e = insert(s, key, h);
+            if (e) {
+                e->result.reset();
+                e->inflight = job;
+            }
+            s.misses.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::optional<result_type> result;
+        try {
+            result.emplace(std::invoke(std::forward<F>(f), key));
+        }
+        catch (...) {
+            finish(s, key, h, job, std::nullopt, std::current_exception());
+            throw;
+        }
+        finish(s, key, h, job, result, nullptr);
+        return std::move(*result);
+    }
+
+    /// @brief: drops the entry for `key`, a computation in flight for it still completes but isn't cached
+    auto erase(const K& key) ->void {
+        const auto h = hash_(key);
+        auto& s = shards_[h % shards_.size()];
+        std::unique_lock<std::shared_mutex> lock(s.mutex);
+        if (auto* e = find(s, key, h)) remove(s, static_cast<std::size_t>(e - s.slots.data()));
+    }
+
+    auto clear() ->void {
+        for (auto& s : shards_) {
+            std::unique_lock<std::shared_mutex> lock(s.mutex);
+            for (auto& e : s.slots) e.reset();
+            s.size = 0;
+        }
+    }
+
+    auto stats() const noexcept ->cache_stats {
+        cache_stats total{};
+        for (const auto& s : shards_) {
+            total.hits += s.hits.load(std::memory_order_relaxed);
+            total.negative_hits += s.negative_hits.load(std::memory_order_relaxed);
+            total.misses += s.misses.load(std::memory_order_relaxed);
+            total.coalesced += s.coalesced.load(std::memory_order_relaxed);
+            total.evictions += s.evictions.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+private:
+    /// @brief: Fibonacci hashing, so that weak hashes such as the identity `std::hash<int>` still spread out
+    auto home(const shard& s, std::size_t h) const noexcept ->std::size_t {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(h / shards_.size()) * 0x9e3779b97f4a7c15ull) >> s.shift);
+    }
+
+    auto find(shard& s, const K& key, std::size_t h) ->slot* {
+        const auto mask = s.slots.size() - 1;
+        for (auto i = home(s, h);; i = (i + 1) & mask) {
+            auto& e = s.slots[i];
+            if (!e.key) return nullptr;
+            if (e.hash == h && equal_(*e.key, key)) return &e;
+        }
+    }
+
+    auto hit(shard& s, slot& e) ->result_type {
+        e.referenced.store(true, std::memory_order_relaxed);
+        (e.result->has_value() ? s.hits : s.negative_hits).fetch_add(1, std::memory_order_relaxed);
+        return *e.result;
+    }
+
+    auto join(shard& s, pending& job) ->result_type {
+        s.coalesced.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.done.wait(lock, [&] { return job.result || job.exception; });
+        if (job.exception) std::rethrow_exception(job.exception);
+        return *job.result;
+    }
+
+    /// @return: a new entry for `key`, or `nullptr` if the shard is full of computations in flight
+    auto insert(shard& s, const K& key, std::size_t h) ->slot* {
+        if (s.size >= s.capacity && !evict(s) && s.size + 1 >= s.slots.size()) return nullptr;
+        const auto mask = s.slots.size() - 1;
+        auto i = home(s, h);
+        while (s.slots[i].key) i = (i + 1) & mask;
+        auto& e = s.slots[i];
+        e.key.emplace(key);
+        e.hash = h;
+        e.referenced.store(false, std::memory_order_relaxed);
+        ++s.size;
+        return &e;
+    }
+
+    /// @brief: CLOCK over the occupied slots: expired entries go first, then the first one not hit since the last sweep
+    auto evict(shard& s) ->bool {
+        const auto now = clock::now();
+        for (std::size_t step = 0; step < 2 * s.slots.size(); ++step) {
+            const auto i = s.hand;
+            s.hand = (s.hand + 1) & (s.slots.size() - 1);
+            auto& e = s.slots[i];
+            if (!e.key || e.inflight) continue;
+            if (now < e.expires && e.referenced.exchange(false, std::memory_order_relaxed)) continue;
+            remove(s, i);
+            s.evictions.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief: empties slot `i`, shifting the rest of its probe run back so that lookups need no tombstones
+    auto remove(shard& s, std::size_t i) ->void {
+        const auto mask = s.slots.size() - 1;
+        s.slots[i].reset();
+        --s.size;
+        for (auto j = (i + 1) & mask; s.slots[j].key; j = (j + 1) & mask) {
+            const auto k = home(s, s.slots[j].hash);
+            if (((j - k) & mask) >= ((j - i) & mask)) {
+                s.slots[i].take(s.slots[j]);
+                i = j;
+            }
+        }
+    }
+
+    auto finish(shard& s, const K& key, std::size_t h, const std::shared_ptr<pending>& job,
+        const std::optional<result_type>& result, std::exception_ptr exception) ->void {
+        {
+            std::unique_lock<std::shared_mutex> lock(s.mutex);
+            auto* e = find(s, key, h);
+            if (e && e->inflight == job) {
+                const auto ttl = !result ? clock::duration::zero() : result->has_value() ? options_.value_ttl : options_.error_ttl;
+                if (ttl <= clock::duration::zero())
+                    remove(s, static_cast<std::size_t>(e - s.slots.data()));
+                else {
+                    e->inflight.reset();
+                    e->result = result;
+                    const auto now = clock::now();
+                    e->expires = ttl >= clock::time_point::max() - now ? clock::time_point::max() : now + ttl;
+                }
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (result)
+                job->result = result;
+            else
+                job->exception = std::move(exception);
+        }
+        job->done.notify_all();
+    }
+
+    cache_options options_;
+    Hash hash_;
+    KeyEqual equal_;
+    std::vector<shard> shards_;
+};
+
+/// @brief: `f` behind an `expected_cache`, called with one key of type `K`
+/// @warning: `f` is called from every thread that misses, so it must be safe to call concurrently
+template<typename K, typename F>
+class memoized {
+    using result_type = remove_cvref_t<std::invoke_result_t<F&, const K&>>;
+    static_assert(is_template_expected_instance_class_v<result_type>, "type `F` must return an `expected`");
+public:
+    explicit memoized(F f, cache_options options = {}) : f_(std::move(f)), cache_(options) {}
+
+    auto operator()(const K& key) ->result_type {
+        return cache_.get_or_compute(key, f_);
+    }
+
+    auto cache() noexcept ->expected_cache<K, typename result_type::value_type, typename result_type::error_type>& {
+        return cache_;
+    }
+private:
+    F f_;
+    expected_cache<K, typename result_type::value_type, typename result_type::error_type> cache_;
+};
+
+/// @brief: e.g. `auto resolve = ccat::memoize<std::string>(lookup_host);`, then `resolve("example.org")`
+template<typename K, typename F>
+auto memoize(F f, cache_options options = {}) ->memoized<K, F> {
+    return memoized<K, F>(std::move(f), options);
+}
+
+}
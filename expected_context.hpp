@@ -0,0 +1,257 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <cstddef>
+#include <string>
+#include <utility>
+
+/// @brief: number of hops a `context_error` keeps, older hops are dropped and only counted
+#ifndef CCAT_EXPECTED_CONTEXT_DEPTH
+#define CCAT_EXPECTED_CONTEXT_DEPTH 8
+#endif
+
+namespace ccat {
+
+/// @brief: one hop of an error's way up the call stack.
+/// every member points to a string literal, so recording a hop never allocates
+struct context_hop {
+    const char* message;
+    const char* file;
+    const char* function;
+    unsigned line;
+};
+
+namespace detail {
+
+/// @brief: the hops of one `context_error`, a ring of the last `CCAT_EXPECTED_CONTEXT_DEPTH` of them
+struct context_ring {
+    context_hop hops[CCAT_EXPECTED_CONTEXT_DEPTH];
+    std::size_t count;
+    context_ring* next;
+};
+
+/// @brief: a per-thread free list of rings, so the failure path allocates only until the list has warmed up.
+/// a ring released on another thread than the one that acquired it joins that thread's list
+class context_pool {
+public:
+    static auto acquire() ->context_ring* {
+        auto& pool = local();
+        if (auto* r = pool.free_) {
+            pool.free_ = r->next;
+            return r;
+        }
+        return new context_ring;
+    }
+    static auto release(context_ring* r) noexcept ->void {
+        /// @note: a ring released by a `thread_local` destroyed after the pool is freed at once
+        if (gone()) {
+            delete r;
+            return;
+        }
+        auto& pool = local();
+        r->next = pool.free_;
+        pool.free_ = r;
+    }
+
+    context_pool(const context_pool&) = delete;
+    auto operator= (const context_pool&) ->context_pool& = delete;
+    ~context_pool() {
+        while (free_) delete std::exchange(free_, free_->next);
+        gone() = true;
+    }
+private:
+    context_pool() = default;
+
+    static auto local() ->context_pool& {
+        thread_local context_pool pool;
+        return pool;
+    }
+    static auto gone() noexcept ->bool& {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    context_ring* free_ = nullptr;
+};
+
+}
+
+/// @brief: an error `E` together with the last `CCAT_EXPECTED_CONTEXT_DEPTH` hops it passed through.
+/// the hops live out of line, in a ring taken from a per-thread pool on the first hop, so `context_error<E>` is
+/// only a pointer larger than `E` and moving it moves `E` and the pointer. attaching a hop is a handful of stores,
+/// formatting them happens only in `describe()`
+template<typename E>
+class context_error {
+    static_assert(std::is_object_v<E> && !std::is_const_v<E>, "type `E` must be a non-const object-type");
+public:
+    using error_type = E;
+
+    constexpr static std::size_t capacity = CCAT_EXPECTED_CONTEXT_DEPTH;
+    static_assert(capacity > 0, "`CCAT_EXPECTED_CONTEXT_DEPTH` must be positive");
+
+    template<typename G = E, typename = std::enable_if_t<std::is_constructible_v<E, G>>>
+    explicit context_error(G&& e) noexcept(std::is_nothrow_constructible_v<E, G>) : error_(std::forward<G>(e)) {}
+
+    context_error(const context_error& other) : error_(other.error_), ring_(copy(other.ring_)) {}
+    context_error(context_error&& other) noexcept(std::is_nothrow_move_constructible_v<E>) :
+        error_(std::move(other.error_)), ring_(std::exchange(other.ring_, nullptr)) {}
+    auto operator= (const context_error& other) ->context_error& {
+        if (this != &other) {
+            auto* ring = copy(other.ring_);
+            try {
+                error_ = other.error_;
+            }
+            catch (...) {
+                if (ring) detail::context_pool::release(ring);
+                throw;
+            }
+            if (ring_) detail::context_pool::release(ring_);
+            ring_ = ring;
+        }
+        return *this;
+    }
+    auto operator= (context_error&& other) noexcept(std::is_nothrow_move_assignable_v<E>) ->context_error& {
+        if (this != &other) {
+            error_ = std::move(other.error_);
+            if (ring_) detail::context_pool::release(ring_);
+            ring_ = std::exchange(other.ring_, nullptr);
+        }
+        return *this;
+    }
+    ~context_error() {
+        if (ring_) detail::context_pool::release(ring_);
+    }
+
+    constexpr auto error() & noexcept ->E& {
+        return error_;
+    }
+    constexpr auto error() const& noexcept ->const E& {
+        return error_;
+    }
+    constexpr auto error() && noexcept ->E&& {
+        return std::move(error_);
+    }
+    constexpr auto error() const&& noexcept ->const E&& {
+        return std::move(error_);
+    }
+
+    /// @return: the number of hops attached so far, including the dropped ones
+    auto depth() const noexcept ->std::size_t {
+        return ring_ ? ring_->count : 0;
+    }
+    /// @return: the number of hops still held, at most `capacity`
+    auto size() const noexcept ->std::size_t {
+        return depth() < capacity ? depth() : capacity;
+    }
+    /// @return: the `i`-th held hop, counting from the innermost one
+    auto hop(std::size_t i) const noexcept ->const context_hop& {
+        /// @warning: if `i >= size()`, the behavior is undefined
+        return ring_->hops[(ring_->count - size() + i) % capacity];
+    }
+
+    /// @note: the first hop takes a ring from the pool, which allocates while the pool is empty
+    auto push(const context_hop& h) ->void {
+        if (!ring_) {
+            ring_ = detail::context_pool::acquire();
+            ring_->count = 0;
+        }
+        ring_->hops[ring_->count % capacity] = h;
+        ++ring_->count;
+    }
+
+    /// @return: one line per held hop, innermost first, formatted as `message (file:line in function)`
+    auto describe() const ->std::string {
+        std::string out;
+        if (depth() > capacity) {
+            out += "... ";
+            out += std::to_string(depth() - capacity);
+            out += " earlier hop(s) dropped\n";
+        }
+        for (std::size_t i = 0; i < size(); ++i) {
+            const auto& h = hop(i);
+            out += h.message;
+            out += " (";
+            out += h.file;
+            out += ':';
+            out += std::to_string(h.line);
+            out += " in ";
+            out += h.function;
+            out += ")\n";
+        }
+        return out;
+    }
+
+    template<typename G>
+    friend constexpr auto operator== (const context_error& lhs, const context_error<G>& rhs) ->bool {
+        return lhs.error() == rhs.error();
+    }
+    template<typename G>
+    friend constexpr auto operator!= (const context_error& lhs, const context_error<G>& rhs) ->bool {
+        return !(lhs == rhs);
+    }
+private:
+    static auto copy(const detail::context_ring* ring) ->detail::context_ring* {
+        if (!ring) return nullptr;
+        auto* out = detail::context_pool::acquire();
+        *out = *ring;
+        return out;
+    }
+
+    E error_;
+    detail::context_ring* ring_ = nullptr;
+};
+
+template<typename E>
+context_error(E) -> context_error<E>;
+
+namespace detail {
+
+template<typename E>
+struct is_context_error : std::false_type {};
+template<typename E>
+struct is_context_error<context_error<E>> : std::true_type {};
+
+}
+
+/// @brief: the callable behind `x.transform_error(context("..."))`: wraps an `E` in a `context_error<E>`,
+/// or appends to a `context_error` that is already there, recording the call site of `context()`
+class context {
+public:
+    constexpr explicit context(
+        const char* message,
+        const char* file = CCAT_EXPECTED_CURRENT_FILE,
+        unsigned line = CCAT_EXPECTED_CURRENT_LINE,
+        const char* function = CCAT_EXPECTED_CURRENT_FUNCTION
+    ) noexcept : hop_{message, file, function, line} {}
+
+    /// @note: an rvalue `context_error` is moved, which moves its `E` and steals its ring, and the hop is pushed onto it
+    template<typename G, typename Err = remove_cvref_t<G>>
+    auto operator()(G&& e) const
+        ->std::conditional_t<detail::is_context_error<Err>::value, Err, context_error<Err>> {
+        std::conditional_t<detail::is_context_error<Err>::value, Err, context_error<Err>> out(std::forward<G>(e));
+        out.push(hop_);
+        return out;
+    }
+
+    constexpr auto hop() const noexcept ->const context_hop& {
+        return hop_;
+    }
+private:
+    context_hop hop_;
+};
+
+/// @brief: shorthand for `std::forward<X>(x).transform_error(context(message))`
+template<typename X, typename = std::enable_if_t<is_template_expected_instance_class_v<remove_cvref_t<X>>>>
+constexpr auto with_context(
+    X&& x,
+    const char* message,
+    const char* file = CCAT_EXPECTED_CURRENT_FILE,
+    unsigned line = CCAT_EXPECTED_CURRENT_LINE,
+    const char* function = CCAT_EXPECTED_CURRENT_FUNCTION
+) {
+    return std::forward<X>(x).transform_error(context(message, file, line, function));
+}
+
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define CCAT_EXPECTED_HAS_COROUTINE 1
+#endif
+#endif
+
+#if defined(CCAT_EXPECTED_HAS_COROUTINE)
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+/// @brief: bytes per thread for the frames of coroutines returning `expected`, frames beyond it go to `::operator new`
+#ifndef CCAT_EXPECTED_COROUTINE_ARENA_SIZE
+#define CCAT_EXPECTED_COROUTINE_ARENA_SIZE 16384
+#endif
+
+namespace ccat {
+
+namespace detail {
+
+/// @brief: a coroutine returning `expected` runs to completion (or to the first failed `co_await`) before it returns,
+/// so its frame is freed before its caller's and a per-thread bump stack can hold every frame
+struct coroutine_arena {
+    constexpr static std::size_t align = alignof(std::max_align_t);
+
+    alignas(std::max_align_t) unsigned char buffer[CCAT_EXPECTED_COROUTINE_ARENA_SIZE];
+    std::size_t top = 0;
+
+    static auto rounded(std::size_t n) noexcept ->std::size_t {
+        return (n + align - 1) / align * align;
+    }
+    auto allocate(std::size_t n) ->void* {
+        n = rounded(n);
+        if (n > sizeof(buffer) - top) return ::operator new(n);
+        void* p = buffer + top;
+        top += n;
+        return p;
+    }
+    auto deallocate(void* p, std::size_t n) noexcept ->void {
+        auto* q = static_cast<unsigned char*>(p);
+        if (q >= buffer && q < buffer + sizeof(buffer))
+            top = static_cast<std::size_t>(q - buffer);
+        else
+            ::operator delete(p, rounded(n));
+    }
+
+    static auto local() noexcept ->coroutine_arena& {
+        thread_local coroutine_arena arena;
+        return arena;
+    }
+};
+
+template<typename T, typename E>
+class expected_promise;
+
+/// @brief: reached when a compiler converted the return object of a coroutine before its body completed, whatever
+/// `CCAT_EXPECTED_CONTRACT` says: the result would be the placeholder, not an error the program could be blamed for
+[[noreturn]] CCAT_EXPECTED_COLD inline auto coroutine_converted_early() noexcept ->void {
+    std::fputs("ccat::expected: the result of a coroutine returning `expected` was taken before its body completed\n", stderr);
+    std::abort();
+}
+
+/// @brief: unwraps the value of `x`, or stores its error in the coroutine's result and destroys the coroutine
+template<typename X>
+class expected_awaiter {
+public:
+    explicit expected_awaiter(X&& x) noexcept : x_(std::forward<X>(x)) {}
+
+    auto await_ready() const noexcept ->bool {
+        return x_.has_value();
+    }
+    template<typename T, typename E>
+    auto await_suspend(std::coroutine_handle<expected_promise<T, E>> h) ->void {
+        h.promise().fail(std::forward<X>(x_).error());
+        h.destroy();
+    }
+    auto await_resume() ->decltype(*std::declval<X>()) {
+        return *std::forward<X>(x_);
+    }
+private:
+    X&& x_;
+};
+
+/// @brief: `co_await unexpected(e)` always fails the coroutine with `e`
+/// @warning: GCC 12 copies aggregate temporaries with default member initializers bitwise in `co_await` operands, so
+/// `co_await unexpected(error{"..."})` may hand over an `error` whose members point into the freed coroutine frame.
+/// give such error types a constructor, or build the `unexpected` with `std::in_place`
+template<typename X>
+class unexpected_awaiter {
+public:
+    explicit unexpected_awaiter(X&& x) noexcept : x_(std::forward<X>(x)) {}
+
+    constexpr auto await_ready() const noexcept ->bool {
+        return false;
+    }
+    template<typename T, typename E>
+    auto await_suspend(std::coroutine_handle<expected_promise<T, E>> h) ->void {
+        h.promise().fail(std::forward<X>(x_).error());
+        h.destroy();
+    }
+    [[noreturn]] auto await_resume() noexcept ->void {
+        std::terminate();
+    }
+private:
+    X&& x_;
+};
+
+/// @brief: what a coroutine returning `expected` hands back to its caller before the body runs: it holds the result,
+/// `E{}` until the body stores the real one, and converts to it when the ramp function returns.
+/// @note: relies on that conversion being delayed until the body has completed or failed, which is unspecified in C++20
+/// (CWG2563) but what compilers do when the type of `get_return_object()` differs from the return type. it is verified
+/// with GCC 12 by "tests/coroutine.cpp", which other compilers must pass too. a conversion made before the body completed
+/// aborts the program in every contract mode
+template<typename T, typename E>
+class expected_return_object {
+public:
+    template<typename Promise>
+    explicit expected_return_object(Promise& promise) : result_(unexpect) {
+        promise.bind(result_, completed_);
+    }
+    expected_return_object(const expected_return_object&) = delete;
+    auto operator= (const expected_return_object&) ->expected_return_object& = delete;
+
+    operator expected<T, E>() && noexcept(std::is_nothrow_move_constructible_v<expected<T, E>>) {
+        if (CCAT_EXPECTED_UNLIKELY(!completed_))
+            coroutine_converted_early();
+        return std::move(result_);
+    }
+private:
+    expected<T, E> result_;
+    bool completed_ = false;
+};
+
+template<typename T, typename E>
+class expected_promise_base {
+    static_assert(std::is_default_constructible_v<E>, "type `E` must be default-constructible to be returned from a coroutine");
+public:
+    auto get_return_object() ->expected_return_object<T, E> {
+        return expected_return_object<T, E>(*this);
+    }
+    auto bind(expected<T, E>& result, bool& completed) noexcept ->void {
+        result_ = std::addressof(result);
+        completed_ = std::addressof(completed);
+    }
+
+    constexpr auto initial_suspend() const noexcept ->std::suspend_never {
+        return {};
+    }
+    constexpr auto final_suspend() const noexcept ->std::suspend_never {
+        return {};
+    }
+    /// @brief: lets the exception leave the ramp function, as the body never suspends: the compiler then destroys the
+    /// frame, its parameters and the promise before the exception reaches the caller, which "tests/coroutine.cpp" checks.
+    /// keeping the exception for the return object to rethrow instead would throw out of the ramp after the frame is gone,
+    /// and GCC 12 destroys it a second time on the way out
+    auto unhandled_exception() ->void {
+        throw;
+    }
+
+    template<typename X, typename = std::enable_if_t<is_template_expected_instance_class_v<remove_cvref_t<X>>>>
+    auto await_transform(X&& x) noexcept ->expected_awaiter<X> {
+        return expected_awaiter<X>(std::forward<X>(x));
+    }
+    template<typename X, typename = std::enable_if_t<is_template_unexpected_instance_class_v<remove_cvref_t<X>>>, typename = void>
+    auto await_transform(X&& x) noexcept ->unexpected_awaiter<X> {
+        return unexpected_awaiter<X>(std::forward<X>(x));
+    }
+
+    template<typename G>
+    auto fail(G&& e) ->void {
+        result_->operator=(unexpected<E>(std::in_place, std::forward<G>(e)));
+        *completed_ = true;
+    }
+
+    static auto operator new(std::size_t n) ->void* {
+        return coroutine_arena::local().allocate(n);
+    }
+    static auto operator delete(void* p, std::size_t n) noexcept ->void {
+        coroutine_arena::local().deallocate(p, n);
+    }
+protected:
+    expected<T, E>* result_ = nullptr;
+    bool* completed_ = nullptr;
+};
+
+template<typename T, typename E>
+class expected_promise : public expected_promise_base<T, E> {
+public:
+    template<typename U = T>
+    auto return_value(U&& x) ->void {
+        *this->result_ = std::forward<U>(x);
+        *this->completed_ = true;
+    }
+};
+
+template<typename E>
+class expected_promise<void, E> : public expected_promise_base<void, E> {
+public:
+    auto return_void() ->void {
+        this->result_->emplace();
+        *this->completed_ = true;
+    }
+};
+
+}
+
+}
+
+/// @brief: a function returning `ccat::expected<T, E>` may be a coroutine: `co_await x` on an `expected` yields its value
+/// or returns its error from the function, `co_await ccat::unexpected(e)` returns `e`, and `co_return` sets the value.
+/// frames live on a per-thread stack arena, so no call allocates unless frames outgrow `CCAT_EXPECTED_COROUTINE_ARENA_SIZE`
+template<typename T, typename E, typename... Args>
+struct std::coroutine_traits<ccat::expected<T, E>, Args...> {
+    using promise_type = ccat::detail::expected_promise<T, E>;
+};
+
+#endif
@@ -0,0 +1,301 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <system_error>
+
+/// @brief: bytes of payload a `ccat::error` holds inline, larger payloads are moved to the heap.
+/// enough for a `std::string` by default, and never less than a pointer, which is what a heap payload is held by
+#ifndef CCAT_EXPECTED_ERROR_BUFFER_SIZE
+#define CCAT_EXPECTED_ERROR_BUFFER_SIZE sizeof(std::string)
+#endif
+
+namespace ccat {
+
+namespace detail {
+
+using std::to_string;
+
+template<typename P>
+auto to_string_adl(const P& p) ->decltype(to_string(p)) {
+    return to_string(p);
+}
+
+template<typename P, typename = void>
+struct has_message_member : std::false_type {};
+template<typename P>
+struct has_message_member<P, std::void_t<decltype(std::string(std::declval<const P&>().message()))>> : std::true_type {};
+
+template<typename P, typename = void>
+struct has_code_member : std::false_type {};
+template<typename P>
+struct has_code_member<P, std::void_t<decltype(std::error_code(std::declval<const P&>().code()))>> : std::true_type {};
+
+/// @brief: error code enumerations, and error condition enumerations such as `std::errc` that `make_error_code` accepts
+template<typename P, typename = void>
+struct has_make_error_code : std::false_type {};
+template<typename P>
+struct has_make_error_code<P, std::enable_if_t<std::is_enum_v<P>, std::void_t<decltype(std::error_code(make_error_code(std::declval<P>())))>>> : std::true_type {};
+
+/// @brief: payloads such as numbers that `to_string`, found by ADL or in `std`, can describe
+template<typename P, typename = void>
+struct has_to_string : std::false_type {};
+template<typename P>
+struct has_to_string<P, std::void_t<decltype(std::string(detail::to_string_adl(std::declval<const P&>())))>> : std::true_type {};
+
+template<typename P>
+constexpr bool is_code_payload_v = std::is_same_v<P, std::error_code> || has_make_error_code<P>::value;
+
+template<typename P>
+constexpr bool is_string_payload_v = std::is_same_v<P, std::string> || std::is_same_v<P, const char*>;
+
+template<typename P>
+auto payload_code(const P& p) ->std::error_code {
+    if constexpr (std::is_same_v<P, std::error_code>)
+        return p;
+    else if constexpr (has_make_error_code<P>::value)
+        return make_error_code(p);
+    else if constexpr (has_code_member<P>::value)
+        return std::error_code(p.code());
+    else
+        return std::error_code{};
+}
+
+/// @brief: the payloads `error` converts from implicitly, the ones `message()` and `code()` are documented to ask
+template<typename P>
+constexpr bool is_described_payload_v = is_code_payload_v<P> || is_string_payload_v<P> || has_message_member<P>::value || has_code_member<P>::value;
+
+template<typename P>
+auto payload_message(const P& p) ->std::string {
+    if constexpr (has_message_member<P>::value)
+        return std::string(p.message());
+    else if constexpr (std::is_same_v<P, const char*>)
+        return p ? std::string(p) : std::string("(null)");
+    else if constexpr (is_string_payload_v<P>)
+        return std::string(p);
+    else if constexpr (is_code_payload_v<P> || has_code_member<P>::value)
+        return payload_code(p).message();
+    else if constexpr (has_to_string<P>::value)
+        return std::string(detail::to_string_adl(p));
+    else
+        return std::string("an error of a payload type that doesn't describe itself");
+}
+
+/// @brief: the per-payload-type operations of a `ccat::error`, one static table for each payload type
+struct error_vtable {
+    /// @brief: move-constructs the payload at `dst` from the one at `src` and destroys the latter
+    void (*relocate)(void* dst, void* src) noexcept;
+    /// @note: `nullptr` for a payload that can't be copied
+    void (*copy)(void* dst, const void* src);
+    void (*destroy)(void* self) noexcept;
+    auto (*message)(const void* self) ->std::string;
+    auto (*code)(const void* self) ->std::error_code;
+    const void* type;
+};
+
+template<typename P>
+inline constexpr char error_type_id = 0;
+
+template<typename P>
+struct error_payload {
+    static_assert(CCAT_EXPECTED_ERROR_BUFFER_SIZE >= sizeof(void*), "`CCAT_EXPECTED_ERROR_BUFFER_SIZE` must fit a pointer");
+
+    constexpr static bool stored_inline =
+        sizeof(P) <= CCAT_EXPECTED_ERROR_BUFFER_SIZE && alignof(P) <= alignof(void*) && std::is_nothrow_move_constructible_v<P>;
+
+    static auto get(const void* self) noexcept ->const P* {
+        if constexpr (stored_inline)
+            return std::launder(static_cast<const P*>(self));
+        else
+            return *static_cast<P* const*>(self);
+    }
+    static auto get(void* self) noexcept ->P* {
+        return const_cast<P*>(get(static_cast<const void*>(self)));
+    }
+
+    template<typename... Args>
+    static auto construct(void* self, Args&&... args) ->void {
+        if constexpr (stored_inline)
+            ::new(self) P(std::forward<Args>(args)...);
+        else
+            ::new(self) P*(new P(std::forward<Args>(args)...));
+    }
+    static auto relocate(void* dst, void* src) noexcept ->void {
+        if constexpr (!stored_inline || std::is_trivially_copyable_v<P>)
+            std::memcpy(dst, src, CCAT_EXPECTED_ERROR_BUFFER_SIZE);
+        else {
+            ::new(dst) P(std::move(*get(src)));
+            get(src)->~P();
+        }
+    }
+    static auto copy(void* dst, const void* src) ->void {
+        construct(dst, *get(src));
+    }
+    constexpr static auto copier() noexcept ->void (*)(void*, const void*) {
+        if constexpr (std::is_copy_constructible_v<P>)
+            return &copy;
+        else
+            return nullptr;
+    }
+    static auto destroy(void* self) noexcept ->void {
+        if constexpr (stored_inline)
+            get(self)->~P();
+        else
+            delete get(self);
+    }
+    static auto message(const void* self) ->std::string {
+        return payload_message(*get(self));
+    }
+    static auto code(const void* self) ->std::error_code {
+        return payload_code(*get(self));
+    }
+
+    constexpr static error_vtable vtable{&relocate, copier(), &destroy, &message, &code, &error_type_id<P>};
+};
+
+}
+
+/// @brief: `P` can be held by a `ccat::error` when it is a movable non-const object-type.
+/// `message()` and `code()` ask the payload when it is an error code, an enumeration `make_error_code` accepts, a string,
+/// or has a `message()` or `code()` member; `message()` falls back to `to_string(payload)` and then to a generic text
+template<typename P>
+constexpr bool is_error_payload_v = std::is_object_v<P> && !std::is_const_v<P> && std::is_move_constructible_v<P>;
+
+/// @brief: thrown when copying an `error` whose payload can't be copied
+class bad_error_copy : public std::exception {
+public:
+    auto what() const noexcept ->const char* override {
+        return "ccat::bad_error_copy: the payload of this error can't be copied";
+    }
+};
+
+class error;
+
+template<typename P>
+struct is_ccat_error : std::is_same<P, error> {};
+
+/// @brief: a type-erased error, small enough to be the `E` of any `expected`.
+/// payloads up to `CCAT_EXPECTED_ERROR_BUFFER_SIZE` bytes are kept inline, so wrapping a `std::error_code`,
+/// an error code enumeration or a string literal never allocates. `message()` and `code()` dispatch through
+/// a static table per payload type, and moving an `error` never throws. a move-only payload, such as a
+/// `std::unique_ptr`, is held too, but copying the `error` then throws `bad_error_copy`
+class error {
+public:
+    /// @brief: an empty error, whose `message()` is empty and whose `code()` is `std::error_code{}`
+    error() noexcept = default;
+
+    /// @brief: converts implicitly from the payloads that describe themselves: error codes, error code enumerations,
+    /// strings, and types with a `message()` or `code()` member
+    /// @note: a `const char*` payload is stored as the pointer, so it must point to a string with static storage duration
+    template<typename Q, typename P = std::decay_t<Q>,
+        std::enable_if_t<!is_ccat_error<P>::value && is_error_payload_v<P> && detail::is_described_payload_v<P>, int> = 0>
+    error(Q&& payload) noexcept(detail::error_payload<P>::stored_inline && std::is_nothrow_constructible_v<P, Q>) {
+        detail::error_payload<P>::construct(buffer_, std::forward<Q>(payload));
+        vtable_ = &detail::error_payload<P>::vtable;
+    }
+    /// @brief: any other payload, such as a number or a plain struct, must be wrapped explicitly
+    template<typename Q, typename P = std::decay_t<Q>,
+        std::enable_if_t<!is_ccat_error<P>::value && is_error_payload_v<P> && !detail::is_described_payload_v<P>, int> = 0>
+    explicit error(Q&& payload) noexcept(detail::error_payload<P>::stored_inline && std::is_nothrow_constructible_v<P, Q>) {
+        detail::error_payload<P>::construct(buffer_, std::forward<Q>(payload));
+        vtable_ = &detail::error_payload<P>::vtable;
+    }
+    template<typename P, typename... Args, typename = std::enable_if_t<is_error_payload_v<P>>>
+    explicit error(std::in_place_type_t<P>, Args&&... args)
+        noexcept(detail::error_payload<P>::stored_inline && std::is_nothrow_constructible_v<P, Args...>) {
+        detail::error_payload<P>::construct(buffer_, std::forward<Args>(args)...);
+        vtable_ = &detail::error_payload<P>::vtable;
+    }
+
+    /// @note: throws `bad_error_copy` if the payload of `other` can't be copied
+    error(const error& other) {
+        if (other.vtable_) {
+            if (!other.vtable_->copy) throw bad_error_copy();
+            other.vtable_->copy(buffer_, other.buffer_);
+            vtable_ = other.vtable_;
+        }
+    }
+    error(error&& other) noexcept : vtable_(other.vtable_) {
+        if (vtable_) {
+            vtable_->relocate(buffer_, other.buffer_);
+            other.vtable_ = nullptr;
+        }
+    }
+
+    ~error() {
+        reset();
+    }
+
+    auto operator= (const error& other) ->error& {
+        if (this != &other) *this = error(other);
+        return *this;
+    }
+    auto operator= (error&& other) noexcept ->error& {
+        if (this != &other) {
+            reset();
+            if (other.vtable_) {
+                other.vtable_->relocate(buffer_, other.buffer_);
+                vtable_ = std::exchange(other.vtable_, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    auto reset() noexcept ->void {
+        if (vtable_) std::exchange(vtable_, nullptr)->destroy(buffer_);
+    }
+
+    auto empty() const noexcept ->bool {
+        return vtable_ == nullptr;
+    }
+    explicit operator bool() const noexcept {
+        return vtable_ != nullptr;
+    }
+
+    auto message() const ->std::string {
+        return vtable_ ? vtable_->message(buffer_) : std::string();
+    }
+    auto code() const ->std::error_code {
+        return vtable_ ? vtable_->code(buffer_) : std::error_code();
+    }
+    auto equivalent(const std::error_code& ec) const ->bool {
+        return code() == ec;
+    }
+    auto equivalent(const std::error_condition& cond) const ->bool {
+        return code() == cond;
+    }
+    template<typename Enum, typename = std::enable_if_t<std::is_error_code_enum_v<Enum> || std::is_error_condition_enum_v<Enum>>>
+    auto equivalent(Enum e) const ->bool {
+        return code() == e;
+    }
+
+    template<typename P>
+    auto holds() const noexcept ->bool {
+        return vtable_ && vtable_->type == &detail::error_type_id<P>;
+    }
+    /// @return: the payload if it is a `P`, otherwise `nullptr`
+    template<typename P>
+    auto get_if() const noexcept ->const P* {
+        return holds<P>() ? detail::error_payload<P>::get(buffer_) : nullptr;
+    }
+    template<typename P>
+    auto get_if() noexcept ->P* {
+        return holds<P>() ? detail::error_payload<P>::get(buffer_) : nullptr;
+    }
+
+    friend auto swap(error& lhs, error& rhs) noexcept ->void {
+        error tmp(std::move(lhs));
+        lhs = std::move(rhs);
+        rhs = std::move(tmp);
+    }
+private:
+    const detail::error_vtable* vtable_ = nullptr;
+    alignas(void*) unsigned char buffer_[CCAT_EXPECTED_ERROR_BUFFER_SIZE];
+};
+
+}
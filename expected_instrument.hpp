@@ -0,0 +1,238 @@
+#pragma once
+
+/// @author: ccat
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <new>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/// @brief: distinct failure sites each thread can count, failures at further sites are only counted as dropped
+#ifndef CCAT_EXPECTED_INSTRUMENT_SITES
+#define CCAT_EXPECTED_INSTRUMENT_SITES 256
+#endif
+
+/// @brief: every n-th `bad_expected_access` thrown by `value()` is recorded (and counted n times), `0` records none
+#ifndef CCAT_EXPECTED_INSTRUMENT_THROW_SAMPLE
+#define CCAT_EXPECTED_INSTRUMENT_THROW_SAMPLE 1
+#endif
+
+namespace ccat {
+
+/// @brief: failures counted at one call site, summed over every thread
+struct error_site_stats {
+    std::string file;
+    unsigned line;
+    std::string function;
+    std::string error_type;
+    std::uint64_t failures;
+    std::uint64_t throws;
+};
+
+namespace detail {
+
+/// @brief: one call site in one thread. only the owning thread writes it, and `file` is published last
+struct alignas(64) instrument_slot {
+    std::atomic<const char*> file{nullptr};
+    const char* function = nullptr;
+    const char* error_type = nullptr;
+    unsigned line = 0;
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> throws{0};
+};
+
+/// @brief: the sites of one thread, an open-addressing table that never rehashes so readers can walk it without locks.
+/// blocks are never freed, so the counts of threads that have exited stay visible, but a thread that exits hands its
+/// block to the next thread to start: there are never more blocks than threads that ever ran at the same time
+struct instrument_block {
+    instrument_slot slots[CCAT_EXPECTED_INSTRUMENT_SITES];
+    std::atomic<std::uint64_t> dropped{0};
+    instrument_block* next = nullptr;
+    std::uint64_t throw_tick = 0;
+    std::atomic<bool> in_use{true};
+
+    auto find(const char* file, unsigned line, const char* function, const char* error_type) noexcept ->instrument_slot* {
+        auto h = reinterpret_cast<std::uintptr_t>(file) ^ reinterpret_cast<std::uintptr_t>(error_type) ^ line * std::uintptr_t{0x9e3779b9};
+        for (std::size_t k = 0; k < CCAT_EXPECTED_INSTRUMENT_SITES; ++k, ++h) {
+            auto& slot = slots[h % CCAT_EXPECTED_INSTRUMENT_SITES];
+            const auto* f = slot.file.load(std::memory_order_relaxed);
+            if (f == nullptr) {
+                slot.function = function;
+                slot.error_type = error_type;
+                slot.line = line;
+                slot.file.store(file, std::memory_order_release);
+                return &slot;
+            }
+            if (f == file && slot.line == line && slot.error_type == error_type) return &slot;
+        }
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+};
+
+struct instrument_registry {
+    std::atomic<instrument_block*> head{nullptr};
+
+    static auto get() noexcept ->instrument_registry& {
+        static instrument_registry registry;
+        return registry;
+    }
+    auto add(instrument_block* block) noexcept ->void {
+        block->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+    /// @return: the block of a thread that has exited, a new one, or `nullptr` if there is no memory left for one
+    auto acquire() noexcept ->instrument_block* {
+        for (auto* block = head.load(std::memory_order_acquire); block; block = block->next) {
+            bool in_use = false;
+            if (block->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire, std::memory_order_relaxed)) return block;
+        }
+        auto* block = new(std::nothrow) instrument_block;
+        if (block) add(block);
+        return block;
+    }
+};
+
+/// @brief: the block a thread writes to, released for reuse when the thread exits
+struct instrument_lease {
+    instrument_block* block = instrument_registry::get().acquire();
+
+    instrument_lease() = default;
+    instrument_lease(const instrument_lease&) = delete;
+    auto operator= (const instrument_lease&) ->instrument_lease& = delete;
+    ~instrument_lease() {
+        if (block) block->in_use.store(false, std::memory_order_release);
+    }
+};
+
+/// @return: the block of the calling thread, `nullptr` if none could be allocated, whose failures then go uncounted
+inline auto local_instrument_block() noexcept ->instrument_block* {
+    thread_local instrument_lease lease;
+    return lease.block;
+}
+
+/// @brief: the spelling of a type, cut out of a compiler's signature `... [with E = <type>; ...]` into a fixed buffer
+/// so that naming a type never allocates. longer spellings are truncated
+struct instrument_type_name {
+    char name[128] = {};
+
+    explicit instrument_type_name(const char* signature) noexcept {
+        const char* first = std::strstr(signature, "E = ");
+        const char* from = first ? first + 4 : signature;
+        auto n = first ? std::strcspn(from, ";]") : std::strlen(from);
+        if (n > sizeof(name) - 1) n = sizeof(name) - 1;
+        std::memcpy(name, from, n);
+    }
+};
+
+/// @return: the spelling of `E`, cut out of the compiler's signature of this function once per type
+template<typename E>
+auto type_name_of() noexcept ->const char* {
+#if defined(__GNUC__) || defined(__clang__)
+    static const instrument_type_name type(__PRETTY_FUNCTION__);
+#elif defined(_MSC_VER)
+    static const instrument_type_name type(__FUNCSIG__);
+#else
+    static const instrument_type_name type("?");
+#endif
+    return type.name;
+}
+
+/// @note: never allocates once the thread has its block, and a thread that can't get one doesn't count its failures
+template<typename E>
+auto record_failure(const char* file, unsigned line, const char* function) noexcept ->void {
+    auto* block = local_instrument_block();
+    if (!block) return;
+    if (auto* slot = block->find(file, line, function, type_name_of<E>()))
+        slot->failures.store(slot->failures.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+template<typename E>
+auto record_throw() noexcept ->void {
+    if constexpr (CCAT_EXPECTED_INSTRUMENT_THROW_SAMPLE != 0) {
+        auto* block = local_instrument_block();
+        if (!block) return;
+        if (++block->throw_tick % CCAT_EXPECTED_INSTRUMENT_THROW_SAMPLE != 0) return;
+        if (auto* slot = block->find("", 0, "value", type_name_of<E>()))
+            slot->throws.store(slot->throws.load(std::memory_order_relaxed) + CCAT_EXPECTED_INSTRUMENT_THROW_SAMPLE, std::memory_order_relaxed);
+    }
+}
+
+inline auto write_json_string(std::ostream& out, const std::string& s) ->void {
+    out << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            const char* hex = "0123456789abcdef";
+            out << "\\u00" << hex[c >> 4 & 0xf] << hex[c & 0xf];
+        }
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+}
+
+/// @brief: sums the counters of every thread, this is the only place where they are aggregated
+/// @return: one entry per call site (file, line and error type), sorted by file and line
+inline auto error_sites() ->std::vector<error_site_stats> {
+    std::map<std::tuple<std::string, unsigned, std::string>, error_site_stats> merged;
+    for (auto* block = detail::instrument_registry::get().head.load(std::memory_order_acquire); block; block = block->next) {
+        for (const auto& slot : block->slots) {
+            const auto* file = slot.file.load(std::memory_order_acquire);
+            if (file == nullptr) continue;
+            auto& site = merged.try_emplace(
+                std::make_tuple(std::string(file), slot.line, std::string(slot.error_type)),
+                error_site_stats{file, slot.line, slot.function, slot.error_type, 0, 0}
+            ).first->second;
+            site.failures += slot.failures.load(std::memory_order_relaxed);
+            site.throws += slot.throws.load(std::memory_order_relaxed);
+        }
+    }
+    std::vector<error_site_stats> sites;
+    sites.reserve(merged.size());
+    for (auto& entry : merged) sites.push_back(std::move(entry.second));
+    return sites;
+}
+
+/// @return: failures that weren't counted because a thread ran out of sites
+inline auto dropped_error_sites() noexcept ->std::uint64_t {
+    std::uint64_t n = 0;
+    for (auto* block = detail::instrument_registry::get().head.load(std::memory_order_acquire); block; block = block->next)
+        n += block->dropped.load(std::memory_order_relaxed);
+    return n;
+}
+
+/// @brief: one line per site, `file:line function [E] failures=... throws=...`, throws of `value()` have no file
+inline auto dump_error_sites(std::ostream& out) ->void {
+    for (const auto& site : error_sites()) {
+        out << site.file << ':' << site.line << ' ' << site.function << " [" << site.error_type << "] failures="
+            << site.failures << " throws=" << site.throws << '\n';
+    }
+}
+
+inline auto dump_error_sites_json(std::ostream& out) ->void {
+    out << "{\"dropped\":" << dropped_error_sites() << ",\"sites\":[";
+    bool first = true;
+    for (const auto& site : error_sites()) {
+        out << (first ? "" : ",") << "{\"file\":";
+        detail::write_json_string(out, site.file);
+        out << ",\"line\":" << site.line << ",\"function\":";
+        detail::write_json_string(out, site.function);
+        out << ",\"error_type\":";
+        detail::write_json_string(out, site.error_type);
+        out << ",\"failures\":" << site.failures << ",\"throws\":" << site.throws << '}';
+        first = false;
+    }
+    out << "]}";
+}
+
+}
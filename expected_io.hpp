@@ -0,0 +1,342 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+
+#if defined(__has_include)
+#if __has_include(<unistd.h>) && __has_include(<sys/uio.h>) && __has_include(<sys/mman.h>)
+#define CCAT_EXPECTED_HAS_POSIX_IO 1
+#endif
+#endif
+
+#if defined(CCAT_EXPECTED_HAS_POSIX_IO)
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/// @brief: the most buffers handed to one `readv`/`writev` call, larger vectors are split
+#ifndef CCAT_EXPECTED_IO_MAX_IOV
+#if defined(IOV_MAX)
+#define CCAT_EXPECTED_IO_MAX_IOV IOV_MAX
+#else
+#define CCAT_EXPECTED_IO_MAX_IOV 1024
+#endif
+#endif
+
+namespace ccat {
+
+namespace detail {
+
+inline auto last_error() noexcept ->std::error_code {
+    return std::error_code(errno, std::system_category());
+}
+
+/// @brief: repeats `call()` while it fails with `EINTR`
+template<typename F>
+auto retry_interrupted(F call) noexcept ->expected<std::size_t, std::error_code> {
+    for (;;) {
+        const auto n = call();
+        if (CCAT_EXPECTED_LIKELY(n >= 0)) return static_cast<std::size_t>(n);
+        if (errno != EINTR) return unexpected(last_error());
+    }
+}
+
+/// @brief: calls `call(p, left, done)` until `size` bytes are transferred, `call` returning `0` (end of file) or an error
+template<typename Byte, typename F>
+auto transfer_full(Byte* buffer, std::size_t size, F call) noexcept ->expected<std::size_t, std::error_code> {
+    std::size_t done = 0;
+    while (done < size) {
+        auto n = retry_interrupted([&] { return call(buffer + done, size - done, done); });
+        if (CCAT_EXPECTED_UNLIKELY(!n)) return n;
+        if (*n == 0) break;
+        done += *n;
+    }
+    return done;
+}
+
+/// @brief: calls `call(iov, count, done)` until every buffer is filled, as `transfer_full` does for one buffer.
+/// the caller's `iovec`s are never modified, they are only copied once a call transfers part of them
+template<typename F>
+auto transfer_vectored(const ::iovec* iov, std::size_t count, F call) ->expected<std::size_t, std::error_code> {
+    std::size_t done = 0;
+    std::vector<::iovec> rest;
+    const ::iovec* cur = iov;
+    while (count > 0) {
+        if (cur->iov_len == 0) {
+            ++cur;
+            --count;
+            continue;
+        }
+        const auto batch = count < CCAT_EXPECTED_IO_MAX_IOV ? count : static_cast<std::size_t>(CCAT_EXPECTED_IO_MAX_IOV);
+        auto n = retry_interrupted([&] { return call(cur, static_cast<int>(batch), done); });
+        if (CCAT_EXPECTED_UNLIKELY(!n)) return n;
+        if (*n == 0) break;
+        done += *n;
+        auto left = *n;
+        while (count > 0 && left >= cur->iov_len) {
+            left -= cur->iov_len;
+            ++cur;
+            --count;
+        }
+        if (left > 0) {
+            if (rest.empty()) {
+                rest.assign(cur, cur + count);
+                cur = rest.data();
+            }
+            auto& head = rest[static_cast<std::size_t>(cur - rest.data())];
+            head.iov_base = static_cast<char*>(head.iov_base) + left;
+            head.iov_len -= left;
+        }
+    }
+    return done;
+}
+
+}
+
+/// @brief: one `read`, retried on `EINTR`
+/// @return: the bytes read, `0` at end of file, or the `errno` of the failure
+inline auto read_some(int fd, void* buffer, std::size_t size) noexcept ->expected<std::size_t, std::error_code> {
+    return detail::retry_interrupted([&] { return ::read(fd, buffer, size); });
+}
+
+/// @brief: one `write`, retried on `EINTR`
+inline auto write_some(int fd, const void* buffer, std::size_t size) noexcept ->expected<std::size_t, std::error_code> {
+    return detail::retry_interrupted([&] { return ::write(fd, buffer, size); });
+}
+
+/// @brief: reads until `size` bytes are in `buffer`, continuing after short reads
+/// @return: the bytes read, fewer than `size` only at end of file, or the `errno` of the failure
+inline auto read_full(int fd, void* buffer, std::size_t size) noexcept ->expected<std::size_t, std::error_code> {
+    return detail::transfer_full(static_cast<char*>(buffer), size, [fd](char* p, std::size_t left, std::size_t) {
+        return ::read(fd, p, left);
+    });
+}
+
+/// @brief: writes all of `buffer`, continuing after short writes
+inline auto write_full(int fd, const void* buffer, std::size_t size) noexcept ->expected<std::size_t, std::error_code> {
+    return detail::transfer_full(static_cast<const char*>(buffer), size, [fd](const char* p, std::size_t left, std::size_t) {
+        return ::write(fd, p, left);
+    });
+}
+
+/// @brief: `read_full` at `offset`, without moving the file position
+inline auto pread_full(int fd, void* buffer, std::size_t size, ::off_t offset) noexcept ->expected<std::size_t, std::error_code> {
+    return detail::transfer_full(static_cast<char*>(buffer), size, [fd, offset](char* p, std::size_t left, std::size_t done) {
+        return ::pread(fd, p, left, offset + static_cast<::off_t>(done));
+    });
+}
+
+/// @brief: `write_full` at `offset`, without moving the file position
+inline auto pwrite_full(int fd, const void* buffer, std::size_t size, ::off_t offset) noexcept ->expected<std::size_t, std::error_code> {
+    return detail::transfer_full(static_cast<const char*>(buffer), size, [fd, offset](const char* p, std::size_t left, std::size_t done) {
+        return ::pwrite(fd, p, left, offset + static_cast<::off_t>(done));
+    });
+}
+
+/// @brief: scatters the file into the caller's buffers in order, continuing after short reads
+/// @return: the bytes read, fewer than the buffers hold only at end of file, or the `errno` of the failure
+inline auto readv_full(int fd, const ::iovec* iov, std::size_t count) ->expected<std::size_t, std::error_code> {
+    return detail::transfer_vectored(iov, count, [fd](const ::iovec* v, int n, std::size_t) {
+        return ::readv(fd, v, n);
+    });
+}
+
+/// @brief: gathers the caller's buffers in order into the file, continuing after short writes
+inline auto writev_full(int fd, const ::iovec* iov, std::size_t count) ->expected<std::size_t, std::error_code> {
+    return detail::transfer_vectored(iov, count, [fd](const ::iovec* v, int n, std::size_t) {
+        return ::writev(fd, v, n);
+    });
+}
+
+/// @brief: `readv_full` at `offset`, without moving the file position
+inline auto preadv_full(int fd, const ::iovec* iov, std::size_t count, ::off_t offset) ->expected<std::size_t, std::error_code> {
+    return detail::transfer_vectored(iov, count, [fd, offset](const ::iovec* v, int n, std::size_t done) {
+        return ::preadv(fd, v, n, offset + static_cast<::off_t>(done));
+    });
+}
+
+/// @brief: an owned file descriptor, closed on destruction
+class unique_fd {
+public:
+    unique_fd() noexcept = default;
+    explicit unique_fd(int fd) noexcept : fd_(fd) {}
+    unique_fd(unique_fd&& other) noexcept : fd_(other.release()) {}
+    auto operator= (unique_fd&& other) noexcept ->unique_fd& {
+        if (this != &other) reset(other.release());
+        return *this;
+    }
+    ~unique_fd() {
+        reset();
+    }
+
+    auto get() const noexcept ->int {
+        return fd_;
+    }
+    explicit operator bool() const noexcept {
+        return fd_ >= 0;
+    }
+    auto release() noexcept ->int {
+        const auto fd = fd_;
+        fd_ = -1;
+        return fd;
+    }
+    /// @note: the result of `close` is dropped, as it is for the destructor; call `::close(release())` to see it
+    auto reset(int fd = -1) noexcept ->void {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = fd;
+    }
+private:
+    int fd_ = -1;
+};
+
+/// @brief: `open`, retried on `EINTR`, always with `O_CLOEXEC`
+inline auto open_file(const char* path, int flags, ::mode_t mode = 0644) noexcept ->expected<unique_fd, std::error_code> {
+    for (;;) {
+        const auto fd = ::open(path, flags | O_CLOEXEC, mode);
+        if (CCAT_EXPECTED_LIKELY(fd >= 0)) return unique_fd(fd);
+        if (errno != EINTR) return unexpected(detail::last_error());
+    }
+}
+
+/// @brief: a mapping of part of a file, unmapped on destruction. an empty region maps nothing
+class mapped_region {
+public:
+    mapped_region() noexcept = default;
+    mapped_region(mapped_region&& other) noexcept :
+        base_(std::exchange(other.base_, nullptr)), length_(std::exchange(other.length_, 0)), skip_(std::exchange(other.skip_, 0)) {}
+    auto operator= (mapped_region&& other) noexcept ->mapped_region& {
+        if (this != &other) {
+            unmap();
+            base_ = std::exchange(other.base_, nullptr);
+            length_ = std::exchange(other.length_, 0);
+            skip_ = std::exchange(other.skip_, 0);
+        }
+        return *this;
+    }
+    ~mapped_region() {
+        unmap();
+    }
+
+    /// @brief: maps `size` bytes of `fd` from `offset`, which needs no particular alignment
+    /// @param prot: `PROT_READ`, `PROT_WRITE` or both; writable regions are `MAP_SHARED`, so writes reach the file
+    /// @return: the region, or `EINVAL` for a negative `offset`, or the `errno` of `mmap`
+    static auto map(int fd, ::off_t offset, std::size_t size, int prot = PROT_READ) noexcept ->expected<mapped_region, std::error_code> {
+        if (CCAT_EXPECTED_UNLIKELY(offset < 0)) return unexpected(std::error_code(EINVAL, std::system_category()));
+        if (size == 0) return mapped_region();
+        static const auto page = static_cast<::off_t>(::sysconf(_SC_PAGESIZE));
+        const auto skip = static_cast<std::size_t>(offset % page);
+        auto* base = ::mmap(nullptr, size + skip, prot, (prot & PROT_WRITE) ? MAP_SHARED : MAP_PRIVATE, fd, offset - static_cast<::off_t>(skip));
+        if (CCAT_EXPECTED_UNLIKELY(base == MAP_FAILED)) return unexpected(detail::last_error());
+        return mapped_region(base, size + skip, skip);
+    }
+
+    auto data() const noexcept ->char* {
+        return base_ ? static_cast<char*>(base_) + skip_ : nullptr;
+    }
+    auto size() const noexcept ->std::size_t {
+        return length_ - skip_;
+    }
+    auto empty() const noexcept ->bool {
+        return size() == 0;
+    }
+    auto begin() const noexcept ->char* {
+        return data();
+    }
+    auto end() const noexcept ->char* {
+        return data() + size();
+    }
+
+    /// @brief: forwards `advice` (e.g. `MADV_SEQUENTIAL`, `MADV_WILLNEED`) to `madvise` for the whole region
+    auto advise(int advice) const noexcept ->expected<void, std::error_code> {
+        if (base_ && ::madvise(base_, length_, advice) != 0) return expected<void, std::error_code>(unexpect, detail::last_error());
+        return {};
+    }
+private:
+    mapped_region(void* base, std::size_t length, std::size_t skip) noexcept : base_(base), length_(length), skip_(skip) {}
+
+    auto unmap() noexcept ->void {
+        if (base_) ::munmap(base_, length_);
+    }
+
+    void* base_ = nullptr;
+    std::size_t length_ = 0;
+    std::size_t skip_ = 0;
+};
+
+/// @brief: maps the whole file at `path` for reading. the descriptor is closed again, the mapping outlives it
+inline auto map_file(const char* path) noexcept ->expected<mapped_region, std::error_code> {
+    auto fd = open_file(path, O_RDONLY);
+    if (CCAT_EXPECTED_UNLIKELY(!fd)) return unexpected(fd.error());
+    struct ::stat st;
+    if (::fstat(fd->get(), &st) != 0) return unexpected(detail::last_error());
+    return mapped_region::map(fd->get(), 0, static_cast<std::size_t>(st.st_size));
+}
+
+/// @brief: one read of a batch, filling `[buffer, buffer + size)` from `offset` of `fd`
+struct read_request {
+    int fd;
+    void* buffer;
+    std::size_t size;
+    ::off_t offset;
+};
+
+/// @brief: performs every request of `[requests, requests + count)` and writes its result to `out`, in the same order.
+/// runs of requests on the same descriptor whose ranges follow each other are merged into one `preadv` into the
+/// caller's buffers; if a merged read fails, its requests are retried one by one so that each gets its own error
+/// @return: `out` past the last result
+template<typename OutputIt>
+auto read_batch(const read_request* requests, std::size_t count, OutputIt out) ->OutputIt {
+    std::vector<::iovec> iov;
+    for (std::size_t first = 0; first < count;) {
+        auto last = first + 1;
+        while (last < count && last - first < CCAT_EXPECTED_IO_MAX_IOV && requests[last].fd == requests[first].fd &&
+            requests[last].offset == requests[last - 1].offset + static_cast<::off_t>(requests[last - 1].size)) ++last;
+        if (last - first == 1) {
+            const auto& r = requests[first];
+            *out++ = pread_full(r.fd, r.buffer, r.size, r.offset);
+            first = last;
+            continue;
+        }
+        iov.clear();
+        for (auto i = first; i < last; ++i) iov.push_back(::iovec{requests[i].buffer, requests[i].size});
+        const auto merged = preadv_full(requests[first].fd, iov.data(), iov.size(), requests[first].offset);
+        if (CCAT_EXPECTED_LIKELY(merged.has_value())) {
+            auto left = *merged;
+            for (auto i = first; i < last; ++i) {
+                const auto n = left < requests[i].size ? left : requests[i].size;
+                *out++ = expected<std::size_t, std::error_code>(n);
+                left -= n;
+            }
+        }
+        else {
+            for (auto i = first; i < last; ++i) {
+                const auto& r = requests[i];
+                *out++ = pread_full(r.fd, r.buffer, r.size, r.offset);
+            }
+        }
+        first = last;
+    }
+    return out;
+}
+
+/// @return: the result of every request, in the same order
+inline auto read_batch(const read_request* requests, std::size_t count) ->std::vector<expected<std::size_t, std::error_code>> {
+    std::vector<expected<std::size_t, std::error_code>> results;
+    results.reserve(count);
+    read_batch(requests, count, std::back_inserter(results));
+    return results;
+}
+
+}
+
+#endif
@@ -0,0 +1,375 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace ccat {
+
+/// @brief: a small work-stealing pool: each worker pops tasks from the back of its own queue
+/// and steals from the front of the others when it runs dry
+class thread_pool {
+public:
+    explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        queues_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) queues_.push_back(std::make_unique<worker_queue>());
+        threads_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) threads_.emplace_back([this, i] { work(i); });
+    }
+    thread_pool(const thread_pool&) = delete;
+    auto operator= (const thread_pool&) ->thread_pool& = delete;
+
+    /// @brief: runs the tasks still queued, then joins the workers
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    auto size() const noexcept ->std::size_t {
+        return threads_.size();
+    }
+
+    /// @brief: queues `task`, on the calling worker's own queue when called from inside the pool
+    auto execute(std::function<void()> task) ->void {
+        const auto i = current_pool_ == this ? current_index_ : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[i]->mutex);
+            queues_[i]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            ++pending_;
+        }
+        sleep_cv_.notify_one();
+    }
+
+    /// @brief: runs one queued task on the calling thread, so a thread waiting for the pool can help it
+    /// @return: false if there was nothing to run
+    auto run_one() ->bool {
+        auto task = pop(current_pool_ == this ? current_index_ : 0);
+        if (!task) return false;
+        task();
+        return true;
+    }
+
+    /// @brief: the pool used when no executor is given, with one worker per hardware thread
+    static auto shared() ->thread_pool& {
+        static thread_pool pool;
+        return pool;
+    }
+private:
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    auto pop(std::size_t self) ->std::function<void()> {
+        std::function<void()> task;
+        for (std::size_t k = 0; k < queues_.size() && !task; ++k) {
+            auto& q = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            if (k == 0) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+            else {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+        if (task) {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            --pending_;
+        }
+        return task;
+    }
+
+    auto work(std::size_t self) ->void {
+        current_pool_ = this;
+        current_index_ = self;
+        for (;;) {
+            if (auto task = pop(self)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+            if (stopping_ && pending_ == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<worker_queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_queue_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    /// @note: guarded by `sleep_mutex_` so that a worker going to sleep can't miss a new task
+    std::size_t pending_ = 0;
+    bool stopping_ = false;
+
+    inline static thread_local thread_pool* current_pool_ = nullptr;
+    inline static thread_local std::size_t current_index_ = 0;
+};
+
+/// @brief: handed to tasks that accept it, so that long tasks can stop early once a task before them has failed
+class cancel_token {
+public:
+    cancel_token(const std::atomic<std::size_t>& failed_at, std::size_t index) noexcept : failed_at_(&failed_at), index_(index) {}
+
+    /// @return: whether a task before this one has failed, which makes the result of this one irrelevant
+    auto cancelled() const noexcept ->bool {
+        return failed_at_->load(std::memory_order_relaxed) < index_;
+    }
+private:
+    const std::atomic<std::size_t>* failed_at_;
+    std::size_t index_;
+};
+
+namespace detail {
+
+template<typename X, typename = void>
+struct is_executor : std::false_type {};
+template<typename X>
+struct is_executor<X, std::void_t<decltype(std::declval<X&>().execute(std::declval<std::function<void()>>()))>> : std::true_type {};
+
+/// @brief: what every task of one `when_all`/`parallel_collect` shares: the error of the lowest-indexed failed task,
+/// that index and a countdown. a task is skipped once a task before it has failed, the ones before the failure
+/// still run, so the error reported is the one a sequential loop would have stopped at
+template<typename E>
+struct fanout_state {
+    constexpr static std::size_t none = static_cast<std::size_t>(-1);
+
+    std::atomic<std::size_t> failed_at{none};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t remaining;
+    std::optional<E> error;
+    std::exception_ptr exception;
+
+    explicit fanout_state(std::size_t n) : remaining(n) {}
+
+    auto token(std::size_t index) const noexcept ->cancel_token {
+        return cancel_token(failed_at, index);
+    }
+    auto skips(std::size_t index) const noexcept ->bool {
+        return failed_at.load(std::memory_order_relaxed) < index;
+    }
+    /// @note: read once every task has finished
+    auto failed() const noexcept ->bool {
+        return failed_at.load(std::memory_order_relaxed) != none;
+    }
+    template<typename G>
+    auto fail(std::size_t index, G&& e) ->void {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index >= failed_at.load(std::memory_order_relaxed)) return;
+        error.emplace(std::forward<G>(e));
+        exception = nullptr;
+        failed_at.store(index, std::memory_order_relaxed);
+    }
+    auto fail_with_exception(std::size_t index, std::exception_ptr e) noexcept ->void {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index >= failed_at.load(std::memory_order_relaxed)) return;
+        error.reset();
+        exception = std::move(e);
+        failed_at.store(index, std::memory_order_relaxed);
+    }
+    /// @note: notifies under the lock, since the waiting thread destroys the state as soon as it sees zero
+    auto finish_one() noexcept ->void {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--remaining == 0) done.notify_all();
+    }
+
+    /// @brief: blocks until every task has finished, running queued pool tasks meanwhile when the executor is a `thread_pool`
+    template<typename Executor>
+    auto wait(Executor& executor) ->void {
+        if constexpr (std::is_same_v<Executor, thread_pool>) {
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (remaining == 0) break;
+                }
+                if (!executor.run_one()) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    done.wait_for(lock, std::chrono::microseconds(100), [this] { return remaining == 0; });
+                }
+            }
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return remaining == 0; });
+    }
+};
+
+template<typename F, typename... Args>
+auto invoke_task(F& f, const cancel_token& token, Args&&... args) {
+    if constexpr (std::is_invocable_v<F&, Args..., const cancel_token&>)
+        return std::invoke(f, std::forward<Args>(args)..., token);
+    else
+        return std::invoke(f, std::forward<Args>(args)...);
+}
+
+template<typename F, typename... Args>
+using task_result_t = remove_cvref_t<decltype(invoke_task(std::declval<F&>(), std::declval<const cancel_token&>(), std::declval<Args>()...))>;
+
+/// @brief: what a task's value is kept in until every task has finished: `void_value` for `expected<void, E>`,
+/// and a pointer to the referred object for `expected<T&, E>`
+template<typename X>
+using task_slot_t = std::conditional_t<std::is_void_v<typename X::value_type>, void_value,
+    std::conditional_t<std::is_lvalue_reference_v<typename X::value_type>, std::remove_reference_t<typename X::value_type>*, typename X::value_type>>;
+
+/// @brief: the value of a task returning `X` as a one-element tuple, or an empty one for a `void` task
+template<typename X, typename S>
+auto task_value(S&& slot) {
+    using value_type = typename X::value_type;
+    if constexpr (std::is_void_v<value_type>)
+        return std::tuple<>{};
+    else if constexpr (std::is_lvalue_reference_v<value_type>)
+        return std::tuple<value_type>(*slot);
+    else
+        return std::tuple<value_type>(std::forward<S>(slot));
+}
+
+/// @brief: runs `f` as the `index`-th task, storing its value in `slot` or its error in `state`,
+/// unless a task before it has already failed
+template<typename E, typename T, typename F, typename... Args>
+auto run_task(fanout_state<E>& state, std::size_t index, std::optional<T>& slot, F& f, Args&&... args) noexcept ->void {
+    if (state.skips(index)) return;
+    try {
+        auto r = invoke_task(f, state.token(index), std::forward<Args>(args)...);
+        if (CCAT_EXPECTED_LIKELY(r.has_value())) {
+            if constexpr (std::is_same_v<T, void_value>)
+                slot.emplace();
+            else if constexpr (std::is_lvalue_reference_v<typename decltype(r)::value_type>)
+                slot.emplace(std::addressof(*r));
+            else
+                slot.emplace(*std::move(r));
+        }
+        else
+            state.fail(index, std::move(r).error());
+    }
+    catch (...) {
+        state.fail_with_exception(index, std::current_exception());
+    }
+}
+
+template<typename E, typename RetTy>
+auto fanout_failure(fanout_state<E>& state) ->RetTy {
+    if (state.exception) std::rethrow_exception(state.exception);
+    return RetTy(unexpect, std::move(*state.error));
+}
+
+template<typename Executor, typename... Fs, std::size_t... I>
+auto when_all_impl(Executor& executor, std::index_sequence<I...>, Fs&... fs) {
+    using error_type = typename std::tuple_element_t<0, std::tuple<task_result_t<Fs>...>>::error_type;
+    static_assert((std::is_same_v<typename task_result_t<Fs>::error_type, error_type> && ...), "every task must return the same error type");
+    using values_type = decltype(std::tuple_cat(task_value<task_result_t<Fs>>(std::declval<task_slot_t<task_result_t<Fs>>>())...));
+    using RetTy = expected<values_type, error_type>;
+
+    fanout_state<error_type> state(sizeof...(Fs));
+    std::tuple<std::optional<task_slot_t<task_result_t<Fs>>>...> slots;
+    (executor.execute([&state, &slot = std::get<I>(slots), &f = fs] {
+        run_task(state, I, slot, f);
+        state.finish_one();
+    }), ...);
+    state.wait(executor);
+
+    if (state.failed()) return fanout_failure<error_type, RetTy>(state);
+    return RetTy(std::in_place, std::tuple_cat(task_value<task_result_t<Fs>>(std::move(*std::get<I>(slots)))...));
+}
+
+}
+
+/// @brief: runs every task on `executor` (anything with `execute(std::function<void()>)`) and waits for all of them.
+/// each task returns an `expected` with the same error type, and may take a `const cancel_token&` to notice that
+/// a task before it has failed. tasks not yet started when one before them fails are skipped.
+/// @return: the values in task order, `void` tasks contributing none and `expected<T&, E>` tasks a `T&`,
+/// or the error of the first task in task order to fail, whichever task failed first in time
+/// @note: an exception thrown by a task counts as its failure and is rethrown here
+template<typename Executor, typename... Fs, typename = std::enable_if_t<detail::is_executor<Executor>::value>>
+auto when_all(Executor& executor, Fs... fs) {
+    static_assert(sizeof...(Fs) > 0, "`when_all` needs at least one task");
+    static_assert((is_template_expected_instance_class_v<detail::task_result_t<Fs>> && ...), "every task must return an `expected`");
+    return detail::when_all_impl(executor, std::index_sequence_for<Fs...>{}, fs...);
+}
+template<typename F, typename... Fs, typename = std::enable_if_t<!detail::is_executor<F>::value>>
+auto when_all(F f, Fs... fs) {
+    return when_all(thread_pool::shared(), std::move(f), std::move(fs)...);
+}
+
+/// @brief: calls `f(x)` (or `f(x, token)`) for every `x` in the random-access range `inputs` on `executor`,
+/// a few chunks per worker, and stops starting calls past an input that has failed
+/// @return: the values in input order, `std::reference_wrapper<T>`s if `f` returns `expected<T&, E>`, or the error
+/// of the first input to fail in input order. `expected<void, E>` if `f` returns one
+template<typename Executor, typename Range, typename F, typename = std::enable_if_t<detail::is_executor<Executor>::value>>
+auto parallel_collect(Executor& executor, Range&& inputs, F f) {
+    using iterator = decltype(std::begin(inputs));
+    static_assert(
+        std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<iterator>::iterator_category>,
+        "type `Range` must be a random-access range"
+    );
+    using result_type = detail::task_result_t<F, decltype(*std::declval<iterator>())>;
+    static_assert(is_template_expected_instance_class_v<result_type>, "type `F` must return an `expected`");
+    using value_type = typename result_type::value_type;
+    using error_type = typename result_type::error_type;
+    using slot_type = detail::task_slot_t<result_type>;
+    using element_type = std::conditional_t<std::is_lvalue_reference_v<value_type>,
+        std::reference_wrapper<std::remove_reference_t<value_type>>, value_type>;
+    using RetTy = std::conditional_t<std::is_void_v<value_type>, expected<void, error_type>, expected<std::vector<element_type>, error_type>>;
+
+    const auto first = std::begin(inputs);
+    const auto n = static_cast<std::size_t>(std::distance(first, std::end(inputs)));
+    if (n == 0) return RetTy(std::in_place);
+
+    std::size_t chunks = n;
+    if constexpr (std::is_same_v<Executor, thread_pool>) chunks = std::min(n, executor.size() * 4);
+    std::vector<std::optional<slot_type>> slots(n);
+    detail::fanout_state<error_type> state(chunks);
+    for (std::size_t c = 0; c < chunks; ++c) {
+        executor.execute([&, begin = n * c / chunks, end = n * (c + 1) / chunks] {
+            for (auto i = begin; i < end && !state.skips(i); ++i)
+                detail::run_task(state, i, slots[i], f, first[static_cast<std::ptrdiff_t>(i)]);
+            state.finish_one();
+        });
+    }
+    state.wait(executor);
+
+    if (state.failed()) return detail::fanout_failure<error_type, RetTy>(state);
+    if constexpr (std::is_void_v<value_type>) return RetTy();
+    else {
+        std::vector<element_type> values;
+        values.reserve(n);
+        for (auto& slot : slots) {
+            if constexpr (std::is_lvalue_reference_v<value_type>)
+                values.emplace_back(**slot);
+            else
+                values.push_back(std::move(*slot));
+        }
+        return RetTy(std::in_place, std::move(values));
+    }
+}
+template<typename Range, typename F, typename = std::enable_if_t<!detail::is_executor<remove_cvref_t<Range>>::value>>
+auto parallel_collect(Range&& inputs, F f) {
+    return parallel_collect(thread_pool::shared(), std::forward<Range>(inputs), std::move(f));
+}
+
+}
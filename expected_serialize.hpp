@@ -0,0 +1,248 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#if defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+
+namespace ccat {
+
+/// @brief: version of the wire layout, stored in the high nibble of every tag byte
+inline constexpr std::uint8_t wire_version = 1;
+
+/// @brief: whether every byte of a `T` is part of its value, so that copying a `T` byte for byte writes no padding,
+/// which would be whatever the memory held before. true for types with unique object representations, and for `float`
+/// and `double`. specialize it as `std::true_type` for a type known to have no padding, such as a struct of `double`s
+template<typename T>
+struct is_padding_free : std::bool_constant<
+    std::has_unique_object_representations_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>
+> {};
+
+/// @brief: the wire layout of an `expected<T, E>` with trivially copyable and padding-free `T` and `E`, in host byte order:
+/// a tag byte, padding up to the alignment of `T` and `E`, then the value or the error, then padding up to that
+/// alignment again, so that records packed back to back stay aligned. padding bytes are written as zero
+template<typename T, typename E>
+struct wire_layout {
+    using stored_type = std::conditional_t<std::is_void_v<T>, detail::void_value, T>;
+    static_assert(std::is_trivially_copyable_v<stored_type> && std::is_trivially_copyable_v<E>,
+        "types `T` and `E` must be trivially copyable to be serialized");
+    static_assert((std::is_void_v<T> || is_padding_free<T>::value) && is_padding_free<E>::value,
+        "types `T` and `E` must have no padding bytes to be serialized, see `is_padding_free`");
+
+    constexpr static std::uint8_t value_tag = wire_version << 4 | 0x1;
+    constexpr static std::uint8_t error_tag = wire_version << 4 | 0x2;
+
+    constexpr static std::size_t align = alignof(stored_type) > alignof(E) ? alignof(stored_type) : alignof(E);
+    constexpr static std::size_t payload_offset = align;
+    constexpr static std::size_t payload_size = std::is_void_v<T> ? sizeof(E) : sizeof(stored_type) > sizeof(E) ? sizeof(stored_type) : sizeof(E);
+    /// @brief: bytes of one record, a multiple of `align`
+    constexpr static std::size_t size = (payload_offset + payload_size + align - 1) / align * align;
+
+    static auto valid_tag(std::uint8_t tag) noexcept ->bool {
+        return tag == value_tag || tag == error_tag;
+    }
+};
+
+namespace detail {
+
+template<typename T, typename E>
+auto write_record(const expected<T, E>& x, std::byte* out) noexcept ->void {
+    using layout = wire_layout<T, E>;
+    std::memset(out, 0, layout::size);
+    if (x.has_value()) {
+        out[0] = static_cast<std::byte>(layout::value_tag);
+        if constexpr (!std::is_void_v<T>) std::memcpy(out + layout::payload_offset, std::addressof(*x), sizeof(T));
+    }
+    else {
+        out[0] = static_cast<std::byte>(layout::error_tag);
+        std::memcpy(out + layout::payload_offset, std::addressof(x.error()), sizeof(E));
+    }
+}
+
+template<typename T, typename E>
+auto read_record(const std::byte* in) noexcept ->expected<T, E> {
+    using layout = wire_layout<T, E>;
+    static_assert(std::is_default_constructible_v<typename layout::stored_type> && std::is_default_constructible_v<E>,
+        "types `T` and `E` must be default-constructible to be copied out of a record");
+    if (static_cast<std::uint8_t>(in[0]) == layout::value_tag) {
+        if constexpr (std::is_void_v<T>)
+            return expected<T, E>(std::in_place);
+        else {
+            T value;
+            std::memcpy(std::addressof(value), in + layout::payload_offset, sizeof(T));
+            return expected<T, E>(std::in_place, value);
+        }
+    }
+    E error;
+    std::memcpy(std::addressof(error), in + layout::payload_offset, sizeof(E));
+    return expected<T, E>(unexpect, error);
+}
+
+}
+
+/// @brief: writes `x` as one record at the start of `[buffer, buffer + size)`
+/// @return: the number of bytes written, or `std::errc::no_buffer_space`
+template<typename T, typename E>
+auto serialize_into(const expected<T, E>& x, std::byte* buffer, std::size_t size) noexcept ->expected<std::size_t, std::errc> {
+    using layout = wire_layout<T, E>;
+    if (size < layout::size) return unexpected(std::errc::no_buffer_space);
+    detail::write_record(x, buffer);
+    return layout::size;
+}
+
+/// @brief: writes every element of `[first, last)` as records packed back to back
+/// @return: the number of bytes written, or `std::errc::no_buffer_space` without writing anything
+template<typename InputIt, typename X = remove_cvref_t<typename std::iterator_traits<InputIt>::value_type>>
+auto serialize_all(InputIt first, InputIt last, std::byte* buffer, std::size_t size) ->expected<std::size_t, std::errc> {
+    static_assert(is_template_expected_instance_class_v<X>, "type `InputIt` must iterate over `expected`");
+    using layout = wire_layout<typename X::value_type, typename X::error_type>;
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (size / layout::size < n) return unexpected(std::errc::no_buffer_space);
+    for (auto* out = buffer; first != last; ++first, out += layout::size) detail::write_record(*first, out);
+    return n * layout::size;
+}
+
+/// @brief: reads one record by copying, so `buffer` needs no particular alignment
+/// @return: the decoded `expected`, `std::errc::message_size` if the buffer is too short,
+/// or `std::errc::illegal_byte_sequence` if the tag byte is not one of this version
+template<typename T, typename E>
+auto deserialize(const std::byte* buffer, std::size_t size) noexcept ->expected<expected<T, E>, std::errc> {
+    using layout = wire_layout<T, E>;
+    if (size < layout::size) return unexpected(std::errc::message_size);
+    if (!layout::valid_tag(static_cast<std::uint8_t>(buffer[0]))) return unexpected(std::errc::illegal_byte_sequence);
+    return detail::read_record<T, E>(buffer);
+}
+
+/// @brief: a serialized `expected<T, E>` read where it lies, e.g. in a mapped file or a shared-memory ring,
+/// without copying the value or the error out of it. the buffer must outlive the view
+/// @note: the payload is accessed as the `T` or `E` that was copied into those bytes, as is usual for
+/// trivially copyable types in shared memory (C++23 spells it `std::start_lifetime_as`)
+template<typename T, typename E>
+class expected_array_view;
+
+template<typename T, typename E>
+class expected_view {
+    using layout = wire_layout<T, E>;
+public:
+    using value_type = T;
+    using error_type = E;
+
+    /// @return: a view of the record at `buffer`, `std::errc::message_size` if the buffer is too short,
+    /// `std::errc::bad_address` if it is not aligned to `wire_layout<T, E>::align`,
+    /// or `std::errc::illegal_byte_sequence` if the tag byte is not one of this version
+    static auto from(const std::byte* buffer, std::size_t size) noexcept ->expected<expected_view, std::errc> {
+        if (size < layout::size) return unexpected(std::errc::message_size);
+        if (reinterpret_cast<std::uintptr_t>(buffer) % layout::align != 0) return unexpected(std::errc::bad_address);
+        if (!layout::valid_tag(static_cast<std::uint8_t>(buffer[0]))) return unexpected(std::errc::illegal_byte_sequence);
+        return expected_view(buffer);
+    }
+
+    auto has_value() const noexcept ->bool {
+        return static_cast<std::uint8_t>(record_[0]) == layout::value_tag;
+    }
+    explicit operator bool() const noexcept {
+        return has_value();
+    }
+
+    template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+    auto operator*() const noexcept ->const U& {
+        CCAT_EXPECTED_EXPECTS(has_value(), "`operator*` called on an `expected_view` holding an error");
+        return *std::launder(reinterpret_cast<const U*>(record_ + layout::payload_offset));
+    }
+    template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+    auto operator->() const noexcept ->const U* {
+        return std::addressof(**this);
+    }
+    template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+    auto value() const ->const U& {
+        if (CCAT_EXPECTED_UNLIKELY(!has_value())) detail::throw_bad_expected_access(error());
+        return **this;
+    }
+    auto error() const noexcept ->const E& {
+        CCAT_EXPECTED_EXPECTS(!has_value(), "`error()` called on an `expected_view` holding a value");
+        return *std::launder(reinterpret_cast<const E*>(record_ + layout::payload_offset));
+    }
+
+    /// @brief: copies the record out into an owning `expected`
+    auto get() const noexcept ->expected<T, E> {
+        return detail::read_record<T, E>(record_);
+    }
+
+    auto data() const noexcept ->const std::byte* {
+        return record_;
+    }
+private:
+    template<typename, typename>
+    friend class expected_array_view;
+
+    explicit expected_view(const std::byte* record) noexcept : record_(record) {}
+
+    const std::byte* record_;
+};
+
+/// @brief: an in-place view of records written by `serialize_all`
+template<typename T, typename E>
+class expected_array_view {
+    using layout = wire_layout<T, E>;
+public:
+    /// @return: a view of the `size / wire_layout<T, E>::size` records at `buffer`, with the same errors as
+    /// `expected_view::from`, every tag being checked once here
+    static auto from(const std::byte* buffer, std::size_t size) noexcept ->expected<expected_array_view, std::errc> {
+        if (size % layout::size != 0) return unexpected(std::errc::message_size);
+        if (reinterpret_cast<std::uintptr_t>(buffer) % layout::align != 0) return unexpected(std::errc::bad_address);
+        for (std::size_t offset = 0; offset < size; offset += layout::size) {
+            if (!layout::valid_tag(static_cast<std::uint8_t>(buffer[offset]))) return unexpected(std::errc::illegal_byte_sequence);
+        }
+        return expected_array_view(buffer, size / layout::size);
+    }
+
+    auto size() const noexcept ->std::size_t {
+        return size_;
+    }
+    auto empty() const noexcept ->bool {
+        return size_ == 0;
+    }
+    auto operator[](std::size_t i) const noexcept ->expected_view<T, E> {
+        /// @warning: if `i >= size()`, the behavior is undefined
+        return expected_view<T, E>(records_ + i * layout::size);
+    }
+
+    /// @brief: copies every record out to `out`
+    template<typename OutputIt>
+    auto copy_to(OutputIt out) const ->OutputIt {
+        for (std::size_t i = 0; i < size_; ++i) *out++ = detail::read_record<T, E>(records_ + i * layout::size);
+        return out;
+    }
+private:
+    expected_array_view(const std::byte* records, std::size_t size) noexcept : records_(records), size_(size) {}
+
+    const std::byte* records_;
+    std::size_t size_;
+};
+
+#if defined(__cpp_lib_span)
+template<typename T, typename E>
+auto serialize_into(const expected<T, E>& x, std::span<std::byte> buffer) noexcept ->expected<std::size_t, std::errc> {
+    return serialize_into(x, buffer.data(), buffer.size());
+}
+template<typename InputIt>
+auto serialize_all(InputIt first, InputIt last, std::span<std::byte> buffer) ->expected<std::size_t, std::errc> {
+    return serialize_all(first, last, buffer.data(), buffer.size());
+}
+template<typename T, typename E>
+auto deserialize(std::span<const std::byte> buffer) noexcept ->expected<expected<T, E>, std::errc> {
+    return deserialize<T, E>(buffer.data(), buffer.size());
+}
+#endif
+
+}
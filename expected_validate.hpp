@@ -0,0 +1,248 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <tuple>
+
+namespace ccat {
+
+/// @brief: the errors of a validation, kept inline up to `N` and moved to the heap beyond that
+template<typename E, std::size_t N>
+class error_list {
+    static_assert(std::is_object_v<E> && !std::is_const_v<E>, "type `E` must be a non-const object-type");
+    static_assert(N > 0, "the inline capacity `N` must be positive");
+public:
+    using value_type = E;
+    using size_type = std::size_t;
+    using iterator = E*;
+    using const_iterator = const E*;
+
+    constexpr static size_type inline_capacity = N;
+
+    error_list() noexcept = default;
+    error_list(std::initializer_list<E> il) {
+        reserve(il.size());
+        for (const auto& e : il) push_back(e);
+    }
+    error_list(const error_list& other) {
+        reserve(other.size_);
+        for (const auto& e : other) push_back(e);
+    }
+    error_list(error_list&& other) noexcept(std::is_nothrow_move_constructible_v<E>) {
+        steal(other);
+    }
+    ~error_list() {
+        clear();
+        release();
+    }
+
+    auto operator= (const error_list& other) ->error_list& {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (const auto& e : other) push_back(e);
+        }
+        return *this;
+    }
+    auto operator= (error_list&& other) noexcept(std::is_nothrow_move_constructible_v<E>) ->error_list& {
+        if (this != &other) {
+            clear();
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    auto size() const noexcept ->size_type {
+        return size_;
+    }
+    auto empty() const noexcept ->bool {
+        return size_ == 0;
+    }
+    auto capacity() const noexcept ->size_type {
+        return capacity_;
+    }
+    /// @brief: whether the errors have outgrown the inline storage
+    auto spilled() const noexcept ->bool {
+        return heap_ != nullptr;
+    }
+
+    auto data() noexcept ->E* {
+        return heap_ ? heap_ : std::launder(reinterpret_cast<E*>(buffer_));
+    }
+    auto data() const noexcept ->const E* {
+        return heap_ ? heap_ : std::launder(reinterpret_cast<const E*>(buffer_));
+    }
+    auto begin() noexcept ->iterator {
+        return data();
+    }
+    auto end() noexcept ->iterator {
+        return data() + size_;
+    }
+    auto begin() const noexcept ->const_iterator {
+        return data();
+    }
+    auto end() const noexcept ->const_iterator {
+        return data() + size_;
+    }
+    auto operator[](size_type i) noexcept ->E& {
+        /// @warning: if `i >= size()`, the behavior is undefined
+        return data()[i];
+    }
+    auto operator[](size_type i) const noexcept ->const E& {
+        /// @warning: if `i >= size()`, the behavior is undefined
+        return data()[i];
+    }
+    auto front() const noexcept ->const E& {
+        /// @warning: if the list is empty, the behavior is undefined
+        return data()[0];
+    }
+
+    auto reserve(size_type n) ->void {
+        if (n <= capacity_) return;
+        auto* fresh = allocate(n);
+        try {
+            relocate(fresh, n);
+        }
+        catch (...) {
+            deallocate(fresh);
+            throw;
+        }
+    }
+
+    template<typename... Args>
+    auto emplace_back(Args&&... args) ->E& {
+        if (CCAT_EXPECTED_UNLIKELY(size_ == capacity_)) return grow_back(std::forward<Args>(args)...);
+        auto* e = ::new(static_cast<void*>(data() + size_)) E(std::forward<Args>(args)...);
+        ++size_;
+        return *e;
+    }
+    auto push_back(const E& e) ->void {
+        emplace_back(e);
+    }
+    auto push_back(E&& e) ->void {
+        emplace_back(std::move(e));
+    }
+
+    auto clear() noexcept ->void {
+        for (auto& e : *this) e.~E();
+        size_ = 0;
+    }
+private:
+    /// @brief: takes over the heap block of `other`, or moves its inline errors one by one
+    auto steal(error_list& other) noexcept(std::is_nothrow_move_constructible_v<E>) ->void {
+        if (other.heap_) {
+            heap_ = std::exchange(other.heap_, nullptr);
+            capacity_ = std::exchange(other.capacity_, N);
+            size_ = std::exchange(other.size_, 0);
+            return;
+        }
+        for (auto& e : other) {
+            ::new(static_cast<void*>(data() + size_)) E(std::move(e));
+            ++size_;
+        }
+        other.clear();
+    }
+
+    static auto allocate(size_type n) ->E* {
+        return static_cast<E*>(::operator new(n * sizeof(E), std::align_val_t(alignof(E))));
+    }
+    static auto deallocate(E* p) noexcept ->void {
+        ::operator delete(p, std::align_val_t(alignof(E)));
+    }
+
+    /// @brief: moves the errors into `fresh`, a block of `n`, and makes it the storage. on a throw the list is left
+    /// as it was and `fresh` is still owned by the caller
+    auto relocate(E* fresh, size_type n) ->void {
+        size_type moved = 0;
+        try {
+            for (; moved < size_; ++moved) ::new(static_cast<void*>(fresh + moved)) E(std::move_if_noexcept(data()[moved]));
+        }
+        catch (...) {
+            for (size_type i = 0; i < moved; ++i) fresh[i].~E();
+            throw;
+        }
+        const auto count = size_;
+        clear();
+        release();
+        heap_ = fresh;
+        capacity_ = n;
+        size_ = count;
+    }
+
+    /// @brief: `emplace_back` on a full list. the new error is built in the new block before the old ones move,
+    /// since `args` may refer to one of them, e.g. `list.push_back(list[0])`
+    template<typename... Args>
+    CCAT_EXPECTED_COLD auto grow_back(Args&&... args) ->E& {
+        const auto n = capacity_ * 2;
+        auto* fresh = allocate(n);
+        E* e = nullptr;
+        try {
+            e = ::new(static_cast<void*>(fresh + size_)) E(std::forward<Args>(args)...);
+            relocate(fresh, n);
+        }
+        catch (...) {
+            if (e) e->~E();
+            deallocate(fresh);
+            throw;
+        }
+        ++size_;
+        return *e;
+    }
+
+    auto release() noexcept ->void {
+        if (heap_) deallocate(heap_);
+        heap_ = nullptr;
+        capacity_ = N;
+    }
+
+    alignas(E) unsigned char buffer_[N * sizeof(E)];
+    E* heap_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = N;
+};
+
+namespace detail {
+
+/// @brief: the value of a validated `expected` as a one-element tuple, or an empty one for `expected<void, E>`
+template<typename X>
+auto validated_value(X&& x) {
+    if constexpr (std::is_void_v<typename remove_cvref_t<X>::value_type>)
+        return std::tuple<>{};
+    else
+        return std::tuple<typename remove_cvref_t<X>::value_type>(*std::forward<X>(x));
+}
+
+}
+
+/// @brief: checks every `expected` instead of stopping at the first error, e.g.
+/// `auto r = ccat::validate(check_name(req), check_age(req), check_email(req));`
+/// @return: a tuple of the values (`expected<void, E>` arguments contribute none), or every error in argument order.
+/// the errors stay inline when at most `N` fail, `N` being the number of arguments unless given
+template<std::size_t N = 0, typename X, typename... Xs>
+auto validate(X&& x, Xs&&... xs) {
+    using error_type = typename remove_cvref_t<X>::error_type;
+    static_assert(is_template_expected_instance_class_v<remove_cvref_t<X>> && (is_template_expected_instance_class_v<remove_cvref_t<Xs>> && ...),
+        "every argument must be an `expected`");
+    static_assert((std::is_same_v<typename remove_cvref_t<Xs>::error_type, error_type> && ...), "every argument must have the same error type");
+    constexpr std::size_t capacity = N ? N : 1 + sizeof...(Xs);
+    using errors_type = error_list<error_type, capacity>;
+    using values_type = decltype(std::tuple_cat(detail::validated_value(std::forward<X>(x)), detail::validated_value(std::forward<Xs>(xs))...));
+    using RetTy = expected<values_type, errors_type>;
+
+    if (CCAT_EXPECTED_LIKELY(x.has_value() && (xs.has_value() && ...)))
+        return RetTy(std::in_place, std::tuple_cat(detail::validated_value(std::forward<X>(x)), detail::validated_value(std::forward<Xs>(xs))...));
+    errors_type errors;
+    const auto collect = [&errors](auto&& y) {
+        if (!y.has_value()) errors.push_back(std::forward<decltype(y)>(y).error());
+    };
+    collect(std::forward<X>(x));
+    (collect(std::forward<Xs>(xs)), ...);
+    return RetTy(unexpect, std::move(errors));
+}
+
+}
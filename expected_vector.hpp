@@ -0,0 +1,295 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace ccat {
+
+namespace detail {
+
+inline auto countr_zero(std::uint64_t x) noexcept ->int {
+    /// @warning: if `x` is zero, the behavior is undefined
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    int n = 0;
+    for (; !(x & 1); x >>= 1) ++n;
+    return n;
+#endif
+}
+
+}
+
+/// @brief: a batch of `expected<T, E>` stored as a structure of arrays: values in a dense `T` array,
+/// errors in a side table sorted by index and the discriminators in a bitmap, one bit per element.
+/// a failed element keeps a value-initialized `T` in the dense array
+template<typename T, typename E>
+class expected_vector {
+    static_assert(std::is_object_v<T> && !std::is_const_v<T>, "type `T` must be a non-const object-type");
+    static_assert(std::is_default_constructible_v<T>, "type `T` must be default-constructible");
+    static_assert(std::is_object_v<E>, "type `E` must be an object-type");
+    static_assert(std::is_move_constructible_v<E>, "type `E` must be move-constructible");
+
+    constexpr static std::size_t word_bits = 64;
+public:
+    using value_type = T;
+    using error_type = E;
+    using size_type = std::size_t;
+
+    /// @brief: iterates the values of the elements that have one, skipping failures a bitmap word at a time
+    class value_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        value_iterator() = default;
+
+        auto operator*() const noexcept ->const T& {
+            return values_[index_];
+        }
+        auto operator->() const noexcept ->const T* {
+            return values_ + index_;
+        }
+        /// @brief: position of the current value in the `expected_vector`
+        auto index() const noexcept ->size_type {
+            return index_;
+        }
+        auto operator++() noexcept ->value_iterator& {
+            word_ &= word_ - 1;
+            seek();
+            return *this;
+        }
+        auto operator++(int) noexcept ->value_iterator {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        friend auto operator==(const value_iterator& x, const value_iterator& y) noexcept ->bool {
+            return x.index_ == y.index_;
+        }
+        friend auto operator!=(const value_iterator& x, const value_iterator& y) noexcept ->bool {
+            return x.index_ != y.index_;
+        }
+    private:
+        friend class expected_vector;
+
+        value_iterator(const T* values, const std::uint64_t* bits, size_type words, size_type size) noexcept :
+            values_(values), bits_(bits), words_(words), word_(words ? bits[0] : 0), end_(size) {
+            seek();
+        }
+        value_iterator(size_type size) noexcept : index_(size), end_(size) {}
+
+        auto seek() noexcept ->void {
+            while (word_ == 0) {
+                if (++word_index_ >= words_) {
+                    index_ = end_;
+                    return;
+                }
+                word_ = bits_[word_index_];
+            }
+            index_ = word_index_ * word_bits + static_cast<size_type>(detail::countr_zero(word_));
+        }
+
+        const T* values_ = nullptr;
+        const std::uint64_t* bits_ = nullptr;
+        size_type words_ = 0;
+        size_type word_index_ = 0;
+        std::uint64_t word_ = 0;
+        size_type index_ = 0;
+        size_type end_ = 0;
+    };
+
+    class value_range {
+    public:
+        auto begin() const noexcept ->value_iterator {
+            return value_iterator(self_->values_.data(), self_->bits_.data(), self_->bits_.size(), self_->size());
+        }
+        auto end() const noexcept ->value_iterator {
+            return value_iterator(self_->size());
+        }
+    private:
+        friend class expected_vector;
+        explicit value_range(const expected_vector* self) noexcept : self_(self) {}
+        const expected_vector* self_;
+    };
+
+    expected_vector() = default;
+    explicit expected_vector(const std::vector<expected<T, E>>& results) {
+        reserve(results.size());
+        for (const auto& x : results) push_back(x);
+    }
+    explicit expected_vector(std::vector<expected<T, E>>&& results) {
+        reserve(results.size());
+        for (auto& x : results) push_back(std::move(x));
+    }
+
+    auto size() const noexcept ->size_type {
+        return values_.size();
+    }
+    auto empty() const noexcept ->bool {
+        return values_.empty();
+    }
+    auto reserve(size_type n) ->void {
+        values_.reserve(n);
+        bits_.reserve((n + word_bits - 1) / word_bits);
+    }
+    auto clear() noexcept ->void {
+        values_.clear();
+        bits_.clear();
+        errors_.clear();
+    }
+
+    auto push_back(const expected<T, E>& x) ->void {
+        if (x.has_value())
+            emplace_back(*x);
+        else
+            emplace_back(unexpect, x.error());
+    }
+    auto push_back(expected<T, E>&& x) ->void {
+        if (x.has_value())
+            emplace_back(*std::move(x));
+        else
+            emplace_back(unexpect, std::move(x).error());
+    }
+    template<typename... Args>
+    auto emplace_back(Args&&... args) ->T& {
+        grow_bits();
+        T* v;
+        try {
+            v = &values_.emplace_back(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            shrink_bits();
+            throw;
+        }
+        const auto i = values_.size() - 1;
+        bits_[i / word_bits] |= std::uint64_t{1} << i % word_bits;
+        return *v;
+    }
+    template<typename... Args>
+    auto emplace_back(unexpect_t, Args&&... args) ->E& {
+        grow_bits();
+        try {
+            values_.emplace_back();
+        }
+        catch (...) {
+            shrink_bits();
+            throw;
+        }
+        try {
+            return errors_.emplace_back(values_.size() - 1, E(std::forward<Args>(args)...)).second;
+        }
+        catch (...) {
+            values_.pop_back();
+            shrink_bits();
+            throw;
+        }
+    }
+
+    auto has_value(size_type i) const noexcept ->bool {
+        return bits_[i / word_bits] >> i % word_bits & 1;
+    }
+    auto value(size_type i) noexcept ->T& {
+        /// @warning: if result of `has_value(i)` is false, the returned object is a value-initialized placeholder
+        return values_[i];
+    }
+    auto value(size_type i) const noexcept ->const T& {
+        /// @warning: if result of `has_value(i)` is false, the returned object is a value-initialized placeholder
+        return values_[i];
+    }
+    auto error(size_type i) const noexcept ->const E& {
+        /// @warning: if result of `has_value(i)` is true, the behavior is undefined
+        return find_error(i)->second;
+    }
+    auto get(size_type i) const ->expected<T, E> {
+        if (has_value(i))
+            return expected<T, E>(std::in_place, values_[i]);
+        return expected<T, E>(unexpect, error(i));
+    }
+
+    /// @brief: "all succeeded?" without touching the values or the bitmap
+    auto all_values() const noexcept ->bool {
+        return errors_.empty();
+    }
+    auto count_errors() const noexcept ->size_type {
+        return errors_.size();
+    }
+    /// @return: the error of the first failed element, or `nullptr` if every element has a value
+    auto first_error() const noexcept ->const E* {
+        return errors_.empty() ? nullptr : &errors_.front().second;
+    }
+    /// @return: the index of the first failed element, or `size()` if every element has a value
+    auto first_error_index() const noexcept ->size_type {
+        return errors_.empty() ? size() : errors_.front().first;
+    }
+
+    auto values() const noexcept ->value_range {
+        return value_range(this);
+    }
+    /// @return: `(index, error)` pairs of the failed elements, in index order
+    auto errors() const noexcept ->const std::vector<std::pair<size_type, E>>& {
+        return errors_;
+    }
+
+    auto to_vector() const& ->std::vector<expected<T, E>> {
+        std::vector<expected<T, E>> out;
+        out.reserve(size());
+        auto err = errors_.begin();
+        for (size_type i = 0; i < size(); ++i) {
+            if (has_value(i))
+                out.emplace_back(std::in_place, values_[i]);
+            else
+                out.emplace_back(unexpect, (err++)->second);
+        }
+        return out;
+    }
+    auto to_vector() && ->std::vector<expected<T, E>> {
+        std::vector<expected<T, E>> out;
+        out.reserve(size());
+        auto err = errors_.begin();
+        for (size_type i = 0; i < size(); ++i) {
+            if (has_value(i))
+                out.emplace_back(std::in_place, std::move(values_[i]));
+            else
+                out.emplace_back(unexpect, std::move((err++)->second));
+        }
+        clear();
+        return out;
+    }
+private:
+    auto grow_bits() ->void {
+        if (values_.size() % word_bits == 0) bits_.push_back(0);
+    }
+    /// @brief: undoes `grow_bits` when the element it made room for could not be added
+    auto shrink_bits() noexcept ->void {
+        if (values_.size() % word_bits == 0) bits_.pop_back();
+    }
+    auto find_error(size_type i) const noexcept ->typename std::vector<std::pair<size_type, E>>::const_iterator {
+        return std::lower_bound(errors_.begin(), errors_.end(), i, [](const std::pair<size_type, E>& x, size_type j) {
+            return x.first < j;
+        });
+    }
+
+    std::vector<T> values_;
+    /// @note: bit `i` is set while element `i` has a value
+    std::vector<std::uint64_t> bits_;
+    std::vector<std::pair<size_type, E>> errors_;
+};
+
+}
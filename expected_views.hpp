@@ -0,0 +1,378 @@
+#pragma once
+
+/// @author: ccat
+
+#include "expected.hpp"
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#define CCAT_EXPECTED_HAS_RANGES 1
+#endif
+
+namespace ccat {
+
+namespace detail {
+
+#if defined(CCAT_EXPECTED_HAS_RANGES)
+template<typename R>
+using view_all_t = std::views::all_t<R>;
+
+template<typename R>
+constexpr auto view_all(R&& r) {
+    return std::views::all(std::forward<R>(r));
+}
+
+using view_base = std::ranges::view_base;
+
+template<typename V>
+constexpr auto view_begin(V& v) {
+    return std::ranges::begin(v);
+}
+template<typename V>
+constexpr auto view_end(V& v) {
+    return std::ranges::end(v);
+}
+#else
+/// @brief: what `std::ranges::ref_view` is to C++20, a copyable reference to an lvalue range
+template<typename R>
+class ref_view {
+public:
+    constexpr explicit ref_view(R& r) noexcept : r_(detail::addressof(r)) {}
+
+    constexpr auto begin() const {
+        using std::begin;
+        return begin(*r_);
+    }
+    constexpr auto end() const {
+        using std::end;
+        return end(*r_);
+    }
+private:
+    R* r_;
+};
+
+/// @brief: lvalue ranges are referred to, rvalue ones are moved into the view
+template<typename R>
+using view_all_t = std::conditional_t<std::is_lvalue_reference_v<R>, ref_view<std::remove_reference_t<R>>, remove_cvref_t<R>>;
+
+template<typename R>
+constexpr auto view_all(R&& r) ->view_all_t<R> {
+    if constexpr (std::is_lvalue_reference_v<R>)
+        return view_all_t<R>(r);
+    else
+        return view_all_t<R>(std::move(r));
+}
+
+struct view_base {};
+
+template<typename V>
+constexpr auto view_begin(V& v) {
+    using std::begin;
+    return begin(v);
+}
+template<typename V>
+constexpr auto view_end(V& v) {
+    using std::end;
+    return end(v);
+}
+#endif
+
+template<typename V>
+using view_iterator_t = decltype(view_begin(std::declval<V&>()));
+template<typename V>
+using view_sentinel_t = decltype(view_end(std::declval<V&>()));
+
+/// @brief: what a view yields for the part `Access` of the element `BaseRef` its base iterator dereferences to:
+/// `Access` itself if `BaseRef` is a reference, so the part lives as long as the range does, and a value otherwise,
+/// since a prvalue element, e.g. from `std::views::transform`, is a temporary destroyed before the caller sees the part
+template<typename BaseRef, typename Access>
+using view_reference_t = std::conditional_t<std::is_reference_v<BaseRef>, Access, remove_cvref_t<Access>>;
+
+/// @brief: a callable that stays assignable even if `F` (e.g. a capturing lambda) isn't, as views must be
+template<typename F>
+class view_box {
+public:
+    constexpr explicit view_box(F f) noexcept(std::is_nothrow_move_constructible_v<F>) : f_(std::move(f)) {}
+    view_box(const view_box&) = default;
+    view_box(view_box&&) = default;
+    auto operator= (const view_box& other) ->view_box& {
+        if (this != &other) f_.emplace(*other.f_);
+        return *this;
+    }
+    auto operator= (view_box&& other) noexcept(std::is_nothrow_move_constructible_v<F>) ->view_box& {
+        if (this != &other) f_.emplace(std::move(*other.f_));
+        return *this;
+    }
+
+    constexpr auto get() const noexcept ->const F& {
+        return *f_;
+    }
+private:
+    std::optional<F> f_;
+};
+
+/// @brief: the sentinel of the views below, `it == sentinel` asks the iterator whether it is done
+struct view_sentinel {
+    template<typename It, typename = decltype(std::declval<const It&>().done())>
+    friend constexpr auto operator== (const It& it, view_sentinel) ->bool {
+        return it.done();
+    }
+    template<typename It, typename = decltype(std::declval<const It&>().done())>
+    friend constexpr auto operator== (view_sentinel, const It& it) ->bool {
+        return it.done();
+    }
+    template<typename It, typename = decltype(std::declval<const It&>().done())>
+    friend constexpr auto operator!= (const It& it, view_sentinel) ->bool {
+        return !it.done();
+    }
+    template<typename It, typename = decltype(std::declval<const It&>().done())>
+    friend constexpr auto operator!= (view_sentinel, const It& it) ->bool {
+        return !it.done();
+    }
+};
+
+/// @brief: the iterator shared by the views: `Policy::stop(x)` ends the view at `x`, `Policy::skip(x)` passes over it,
+/// and `Policy::get<base_reference>(x, parent)` is what the view yields for it.
+/// an element the base iterator generates (e.g. from `std::views::transform`) is generated once: it is kept for the
+/// current position, with whether it ends the view, and moved into the first dereference of the iterator
+template<typename Parent, typename V, typename Policy>
+class view_iterator {
+    using base_iterator = view_iterator_t<V>;
+    using base_sentinel = view_sentinel_t<V>;
+    using base_reference = decltype(*std::declval<const base_iterator&>());
+    constexpr static bool caches = !std::is_reference_v<base_reference>;
+    using element_type = std::conditional_t<caches, remove_cvref_t<base_reference>, char>;
+public:
+    using iterator_category = std::input_iterator_tag;
+    using reference = decltype(Policy::template get<base_reference>(std::declval<base_reference>(), std::declval<const Parent&>()));
+    using value_type = remove_cvref_t<reference>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+
+    view_iterator() = default;
+    constexpr view_iterator(const Parent& parent, base_iterator cur, base_sentinel end) :
+        parent_(detail::addressof(parent)), cur_(std::move(cur)), end_(std::move(end)) {
+        settle();
+    }
+
+    constexpr auto operator*() const ->reference {
+        if constexpr (caches) {
+            /// @note: a second dereference of the same position generates the element again
+            if (current_) {
+                reference r = Policy::template get<base_reference>(std::move(*current_), *parent_);
+                current_.reset();
+                return r;
+            }
+        }
+        return Policy::template get<base_reference>(*cur_, *parent_);
+    }
+    constexpr auto operator++() ->view_iterator& {
+        ++cur_;
+        settle();
+        return *this;
+    }
+    constexpr auto operator++(int) ->view_iterator {
+        auto old = *this;
+        ++*this;
+        return old;
+    }
+
+    /// @return: whether the iterator has reached the end of the view
+    constexpr auto done() const ->bool {
+        if constexpr (caches)
+            return cur_ == end_ || current_stops_;
+        else
+            return cur_ == end_ || Policy::stop(*cur_);
+    }
+    /// @return: the iterator into the underlying range, e.g. to find the error that ended a `take_while_ok`
+    constexpr auto base() const& ->const base_iterator& {
+        return cur_;
+    }
+
+    friend constexpr auto operator== (const view_iterator& lhs, const view_iterator& rhs) ->bool {
+        const auto lhs_done = lhs.done();
+        return lhs_done == rhs.done() && (lhs_done || lhs.cur_ == rhs.cur_);
+    }
+    friend constexpr auto operator!= (const view_iterator& lhs, const view_iterator& rhs) ->bool {
+        return !(lhs == rhs);
+    }
+private:
+    constexpr auto settle() ->void {
+        if constexpr (caches) {
+            for (; !(cur_ == end_); ++cur_) {
+                if (!Policy::skip(current_.emplace(*cur_))) {
+                    current_stops_ = Policy::stop(*current_);
+                    return;
+                }
+            }
+            current_.reset();
+            current_stops_ = false;
+        }
+        else {
+            while (!(cur_ == end_) && Policy::skip(*cur_)) ++cur_;
+        }
+    }
+
+    const Parent* parent_ = nullptr;
+    base_iterator cur_{};
+    base_sentinel end_{};
+    mutable std::optional<element_type> current_;
+    bool current_stops_ = false;
+};
+
+/// @brief: the view over `V` that `view_iterator` walks with `Policy`
+template<typename V, typename Policy>
+class expected_view_adaptor : public view_base {
+public:
+    using iterator = view_iterator<expected_view_adaptor, V, Policy>;
+
+    expected_view_adaptor() = default;
+    constexpr explicit expected_view_adaptor(V base, Policy policy = Policy()) : base_(std::move(base)), policy_(std::move(policy)) {}
+
+    /// @note: not cached, so every call walks past the leading elements the view skips again
+    constexpr auto begin() const ->iterator {
+        return iterator(*this, view_begin(base_), view_end(base_));
+    }
+    constexpr auto end() const {
+        if constexpr (std::is_same_v<view_iterator_t<V>, view_sentinel_t<V>>)
+            return iterator(*this, view_end(base_), view_end(base_));
+        else
+            return view_sentinel{};
+    }
+
+    constexpr auto base() const& ->const V& {
+        return base_;
+    }
+    constexpr auto policy() const noexcept ->const Policy& {
+        return policy_;
+    }
+private:
+    /// @note: mutable so that the views can be iterated through a `const&` even over ranges that can't, such as
+    /// `std::views::filter`, as they are single-pass anyway
+    mutable V base_;
+    Policy policy_;
+};
+
+template<typename X>
+constexpr auto view_expected_check() noexcept ->void {
+    static_assert(is_template_expected_instance_class_v<remove_cvref_t<X>>, "the range must be a range of `expected`");
+}
+
+struct values_policy {
+    template<typename X>
+    constexpr static auto stop(X&&) noexcept ->bool {
+        return false;
+    }
+    template<typename X>
+    constexpr static auto skip(X&& x) noexcept ->bool {
+        return !x.has_value();
+    }
+    template<typename BaseRef, typename X, typename Parent>
+    constexpr static auto get(X&& x, const Parent&) ->view_reference_t<BaseRef, decltype(*std::declval<X&&>())> {
+        view_expected_check<X>();
+        static_assert(!std::is_void_v<typename remove_cvref_t<X>::value_type>, "`views::values` needs `expected`s with a value type");
+        return *std::forward<X>(x);
+    }
+};
+
+struct errors_policy {
+    template<typename X>
+    constexpr static auto stop(X&&) noexcept ->bool {
+        return false;
+    }
+    template<typename X>
+    constexpr static auto skip(X&& x) noexcept ->bool {
+        return x.has_value();
+    }
+    template<typename BaseRef, typename X, typename Parent>
+    constexpr static auto get(X&& x, const Parent&) ->view_reference_t<BaseRef, decltype(std::declval<X&&>().error())> {
+        view_expected_check<X>();
+        return std::forward<X>(x).error();
+    }
+};
+
+struct take_while_ok_policy {
+    template<typename X>
+    constexpr static auto stop(X&& x) noexcept ->bool {
+        return !x.has_value();
+    }
+    template<typename X>
+    constexpr static auto skip(X&&) noexcept ->bool {
+        return false;
+    }
+    template<typename BaseRef, typename X, typename Parent>
+    constexpr static auto get(X&& x, const Parent& parent) ->decltype(values_policy::get<BaseRef>(std::forward<X>(x), parent)) {
+        return values_policy::get<BaseRef>(std::forward<X>(x), parent);
+    }
+};
+
+template<typename F>
+struct and_then_policy {
+    view_box<F> f;
+
+    template<typename X>
+    constexpr static auto stop(X&&) noexcept ->bool {
+        return false;
+    }
+    template<typename X>
+    constexpr static auto skip(X&&) noexcept ->bool {
+        return false;
+    }
+    template<typename BaseRef, typename X, typename Parent>
+    constexpr static auto get(X&& x, const Parent& parent) {
+        view_expected_check<X>();
+        return std::forward<X>(x).and_then(parent.policy().f.get());
+    }
+};
+
+/// @brief: the adaptor objects of `ccat::views`, callable on a range and usable after `|`
+template<typename Policy>
+struct view_closure {
+    Policy policy;
+
+    template<typename R>
+    constexpr auto operator()(R&& r) const ->expected_view_adaptor<view_all_t<R>, Policy> {
+        return expected_view_adaptor<view_all_t<R>, Policy>(view_all(std::forward<R>(r)), policy);
+    }
+    template<typename R>
+    friend constexpr auto operator| (R&& r, const view_closure& self) ->expected_view_adaptor<view_all_t<R>, Policy> {
+        return self(std::forward<R>(r));
+    }
+};
+
+}
+
+/// @brief: lazy views over ranges of `expected`, e.g. `for (auto& record : parsed | ccat::views::take_while_ok)`.
+/// they never allocate and walk their range once, so they suit input ranges such as records parsed off a socket.
+/// with C++20 ranges they are `std::ranges::view`s and compose with `std::views`, in C++17 they are plain
+/// iterator pairs over anything `std::begin`/`std::end` accept
+namespace views {
+
+/// @brief: the values of the `expected`s that hold one, skipping the errors
+inline constexpr detail::view_closure<detail::values_policy> values{};
+
+/// @brief: the errors of the `expected`s that hold one, skipping the values
+inline constexpr detail::view_closure<detail::errors_policy> errors{};
+
+/// @brief: the values up to the first error. `end()` is reached at that error, which the underlying iterator,
+/// `it.base()`, then still points at
+inline constexpr detail::view_closure<detail::take_while_ok_policy> take_while_ok{};
+
+/// @brief: `x.and_then(f)` for every `x`, called when the element is dereferenced
+template<typename F>
+constexpr auto and_then(F&& f) ->detail::view_closure<detail::and_then_policy<std::decay_t<F>>> {
+    return {{detail::view_box<std::decay_t<F>>(std::forward<F>(f))}};
+}
+
+}
+
+}
+
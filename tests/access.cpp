@@ -0,0 +1,73 @@
+/// @author: ccat
+
+/// @brief: `value()` on an `expected` holding an error throws `bad_expected_access<E>`, whose `error()` recovers the error:
+/// copied from `&` and `const&` sources, moved from `&&` ones
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <cstring>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+constexpr const char* what_text = "ccat::bad_expected_access: this expect has no value";
+
+/// @brief: long enough to live on the heap, so that a moved-from error is visibly emptied
+const std::string message = "the configuration file could not be parsed at line 42";
+
+/// @return: the error carried by the exception that `access` throws, or the empty string if it threw none
+template<typename F>
+auto caught_error(F access) ->std::string {
+    try {
+        access();
+    }
+    catch (ccat::bad_expected_access<std::string>& e) {
+        CCAT_CHECK(std::strcmp(e.what(), what_text) == 0);
+        const ccat::bad_expected_access<void>& base = e;
+        CCAT_CHECK(std::strcmp(base.what(), what_text) == 0);
+        CCAT_CHECK(std::as_const(e).error() == e.error());
+        return std::move(e).error();
+    }
+    return {};
+}
+
+}
+
+auto main() ->int {
+    expected<int, std::string> lvalue(unexpect, message);
+    CCAT_CHECK(caught_error([&] { static_cast<void>(lvalue.value()); }) == message);
+    CCAT_CHECK(lvalue.error() == message);
+
+    const expected<int, std::string> const_lvalue(unexpect, message);
+    CCAT_CHECK(caught_error([&] { static_cast<void>(const_lvalue.value()); }) == message);
+    CCAT_CHECK(const_lvalue.error() == message);
+
+    expected<int, std::string> rvalue(unexpect, message);
+    CCAT_CHECK(caught_error([&] { static_cast<void>(std::move(rvalue).value()); }) == message);
+    CCAT_CHECK(rvalue.error().empty());
+
+    expected<void, std::string> none(unexpect, message);
+    CCAT_CHECK(caught_error([&] { none.value(); }) == message);
+
+    int n = 0;
+    const expected<int&, std::string> ref(unexpect, message);
+    CCAT_CHECK(caught_error([&] { static_cast<void>(ref.value()); }) == message);
+    CCAT_CHECK(&expected<int&, std::string>(n).value() == &n);
+
+    expected<int, std::string> ok(7);
+    CCAT_CHECK(ok.value() == 7 && std::as_const(ok).value() == 7 && std::move(ok).value() == 7);
+
+    try {
+        static_cast<void>(expected<int, int>(unexpect, 3).value());
+        CCAT_CHECK(false);
+    }
+    catch (const std::exception& e) {
+        CCAT_CHECK(std::strcmp(e.what(), what_text) == 0);
+        CCAT_CHECK(dynamic_cast<const ccat::bad_expected_access<int>&>(e).error() == 3);
+    }
+}
@@ -0,0 +1,84 @@
+/// @author: ccat
+
+/// @brief: the algorithms over ranges of `expected` agree with a plain loop, whether they scan the discriminators
+/// a vector register at a time (arrays of trivially copyable `expected`) or test each element
+
+#include "expected_algorithm.hpp"
+#include "check.hpp"
+#include <list>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+template<typename T>
+auto make_results(std::size_t n, std::size_t every) {
+    std::vector<expected<T, int>> results;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (every && i % every == every - 1) results.emplace_back(unexpect, static_cast<int>(i));
+        else results.emplace_back(T(static_cast<int>(i)));
+    }
+    return results;
+}
+
+template<typename T>
+auto check_against_loop(std::size_t n, std::size_t every) ->void {
+    const auto results = make_results<T>(n, every);
+    std::vector<T> values, loop_values;
+    std::vector<int> errors, loop_errors;
+    for (const auto& x : results) {
+        if (x.has_value()) loop_values.push_back(*x);
+        else loop_errors.push_back(x.error());
+    }
+
+    CCAT_CHECK(ccat::count_failures(results) == loop_errors.size());
+    CCAT_CHECK(ccat::all_of_value(results) == loop_errors.empty());
+    ccat::partition_results(results.data(), results.data() + results.size(), std::back_inserter(values), std::back_inserter(errors));
+    CCAT_CHECK(values == loop_values && errors == loop_errors);
+
+    std::vector<expected<long, int>> transformed;
+    ccat::transform_all(results.data(), results.data() + results.size(), std::back_inserter(transformed), [](T x) { return static_cast<long>(x) * 2; });
+    CCAT_CHECK(transformed.size() == results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        CCAT_CHECK(transformed[i].has_value() == results[i].has_value());
+        if (results[i].has_value()) CCAT_CHECK(*transformed[i] == static_cast<long>(*results[i]) * 2);
+        else CCAT_CHECK(transformed[i].error() == results[i].error());
+    }
+
+    const auto collected = ccat::collect(results);
+    CCAT_CHECK(collected.has_value() == loop_errors.empty());
+    if (collected.has_value()) CCAT_CHECK(*collected == loop_values);
+    else CCAT_CHECK(collected.error() == loop_errors.front());
+}
+
+}
+
+auto main() ->int {
+    for (const std::size_t n : {0, 1, 7, 16, 33, 100, 1000}) {
+        for (const std::size_t every : {0, 1, 2, 5, 17, 64}) {
+            check_against_loop<char>(n, every);
+            check_against_loop<short>(n, every);
+            check_against_loop<int>(n, every);
+            check_against_loop<std::string::size_type>(n, every);
+        }
+    }
+
+    int a = 1, b = 2;
+    std::vector<expected<int&, int>> refs{a, b};
+    auto collected = ccat::collect(refs);
+    CCAT_CHECK(collected.has_value() && collected->size() == 2 && &collected->at(0).get() == &a);
+    collected->at(1).get() = 5;
+    CCAT_CHECK(b == 5);
+    refs.emplace_back(unexpect, 3);
+    CCAT_CHECK(!ccat::collect(refs).has_value() && ccat::collect(refs).error() == 3);
+
+    const std::list<expected<std::string, int>> strings{std::string("x"), expected<std::string, int>(unexpect, 4), std::string("y")};
+    std::vector<std::string> values;
+    std::vector<int> errors;
+    ccat::partition_results(strings.begin(), strings.end(), std::back_inserter(values), std::back_inserter(errors));
+    CCAT_CHECK(values == std::vector<std::string>{"x", "y"} && errors == std::vector<int>{4});
+    CCAT_CHECK(ccat::count_failures(strings) == 1 && ccat::collect(strings).error() == 4);
+}
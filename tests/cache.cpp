@@ -0,0 +1,186 @@
+/// @author: ccat
+
+/// @brief: `expected_cache` serves values and errors for as long as their TTL, evicts at capacity, runs concurrent
+/// misses on one key once, and hands an exception to every caller waiting on it without caching anything
+
+#include "expected_cache.hpp"
+#include "check.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using ccat::cache_options;
+using ccat::expected;
+using ccat::expected_cache;
+using ccat::unexpect;
+
+using result = expected<int, std::string>;
+using cache = expected_cache<int, int, std::string>;
+
+/// @brief: negative keys fail, the others map to twice themselves, and every call is counted
+struct counted {
+    std::atomic<int>* calls;
+
+    auto operator()(int key) const ->result {
+        ++*calls;
+        if (key < 0) return result(unexpect, "negative");
+        return key * 2;
+    }
+};
+
+/// @brief: spins until `done()`, failing the test after a few seconds instead of hanging it
+template<typename Done>
+auto wait_until(Done done) ->void {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done()) {
+        CCAT_CHECK(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::yield();
+    }
+}
+
+auto hits_and_ttl() ->void {
+    std::atomic<int> calls{0};
+    cache_options options;
+    options.value_ttl = std::chrono::milliseconds(50);
+    cache c(options);
+
+    CCAT_CHECK(*c.get_or_compute(1, counted{&calls}) == 2 && calls == 1);
+    CCAT_CHECK(*c.get_or_compute(1, counted{&calls}) == 2 && calls == 1);
+    CCAT_CHECK(c.get_or_compute(-1, counted{&calls}).error() == "negative" && calls == 2);
+    CCAT_CHECK(c.get_or_compute(-1, counted{&calls}).error() == "negative" && calls == 2);
+
+    auto stats = c.stats();
+    CCAT_CHECK(stats.hits == 1 && stats.negative_hits == 1 && stats.misses == 2 && stats.coalesced == 0 && stats.evictions == 0);
+
+    /// @note: an expired value is computed again
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    CCAT_CHECK(*c.get_or_compute(1, counted{&calls}) == 2 && calls == 3);
+    CCAT_CHECK(c.stats().misses == 3);
+
+    c.erase(1);
+    CCAT_CHECK(*c.get_or_compute(1, counted{&calls}) == 2 && calls == 4);
+    c.clear();
+    CCAT_CHECK(c.get_or_compute(-1, counted{&calls}).error() == "negative" && calls == 5);
+}
+
+auto errors_not_cached() ->void {
+    std::atomic<int> calls{0};
+    cache_options options;
+    options.error_ttl = std::chrono::steady_clock::duration::zero();
+    cache c(options);
+
+    for (int i = 1; i <= 3; ++i) CCAT_CHECK(!c.get_or_compute(-7, counted{&calls}).has_value() && calls == i);
+    CCAT_CHECK(*c.get_or_compute(7, counted{&calls}) == 14 && *c.get_or_compute(7, counted{&calls}) == 14 && calls == 4);
+    CCAT_CHECK(c.stats().negative_hits == 0 && c.stats().hits == 1);
+}
+
+auto eviction() ->void {
+    std::atomic<int> calls{0};
+    cache_options options;
+    options.capacity = 4;
+    options.shards = 1;
+    cache c(options);
+
+    for (int k = 0; k < 4; ++k) c.get_or_compute(k, counted{&calls});
+    /// @note: a hit marks key 0, so the CLOCK hand passes it over and evicts another
+    c.get_or_compute(0, counted{&calls});
+    c.get_or_compute(4, counted{&calls});
+    CCAT_CHECK(calls == 5 && c.stats().evictions == 1);
+    c.get_or_compute(0, counted{&calls});
+    c.get_or_compute(4, counted{&calls});
+    CCAT_CHECK(calls == 5);
+
+    for (int k = 5; k < 100; ++k) c.get_or_compute(k, counted{&calls});
+    CCAT_CHECK(c.stats().evictions == 96);
+}
+
+auto erase_in_flight() ->void {
+    std::atomic<bool> started{false}, release{false};
+    std::atomic<int> calls{0};
+    cache c;
+
+    std::thread computing([&] {
+        const auto r = c.get_or_compute(3, [&](int key) {
+            ++calls;
+            started = true;
+            wait_until([&] { return release.load(); });
+            return result(key);
+        });
+        CCAT_CHECK(r.has_value() && *r == 3);
+    });
+    wait_until([&] { return started.load(); });
+    c.erase(3);
+    release = true;
+    computing.join();
+
+    /// @note: the computation completed for its caller, but wasn't cached
+    CCAT_CHECK(*c.get_or_compute(3, [&](int key) { ++calls; return result(key); }) == 3 && calls == 2);
+}
+
+auto coalescing() ->void {
+    constexpr int threads = 8;
+    std::atomic<int> calls{0};
+    cache c;
+
+    std::vector<std::thread> workers;
+    std::atomic<int> sum{0};
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            const auto r = c.get_or_compute(9, [&](int key) {
+                ++calls;
+                /// @note: holds the computation until every other thread waits for it
+                wait_until([&] { return c.stats().coalesced == threads - 1; });
+                return result(key * 2);
+            });
+            sum += *r;
+        });
+    }
+    for (auto& w : workers) w.join();
+    CCAT_CHECK(calls == 1 && sum == threads * 18);
+    const auto stats = c.stats();
+    CCAT_CHECK(stats.misses == 1 && stats.coalesced == threads - 1);
+}
+
+auto exception_reaches_waiters() ->void {
+    constexpr int threads = 4;
+    std::atomic<int> calls{0}, caught{0};
+    cache c;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            try {
+                c.get_or_compute(5, [&](int) ->result {
+                    ++calls;
+                    wait_until([&] { return c.stats().coalesced == threads - 1; });
+                    throw std::runtime_error("lookup failed");
+                });
+            }
+            catch (const std::runtime_error& e) {
+                if (std::string(e.what()) == "lookup failed") ++caught;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    CCAT_CHECK(calls == 1 && caught == threads);
+
+    /// @note: nothing was left behind for the key, the next call computes it afresh
+    CCAT_CHECK(*c.get_or_compute(5, [&](int key) { ++calls; return result(key); }) == 5 && calls == 2);
+    CCAT_CHECK(*c.get_or_compute(5, [&](int key) { ++calls; return result(key); }) == 5 && calls == 2);
+}
+
+}
+
+auto main() ->int {
+    hits_and_ttl();
+    errors_not_cached();
+    eviction();
+    erase_in_flight();
+    coalescing();
+    exception_reaches_waiters();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+/// @author: ccat
+
+#include <cstdio>
+#include <cstdlib>
+
+/// @brief: the assertion of the tests, active whatever `NDEBUG` says
+#define CCAT_CHECK(...) ((__VA_ARGS__) ? void() : ::ccat_test::fail(#__VA_ARGS__, __FILE__, __LINE__))
+
+namespace ccat_test {
+
+[[noreturn]] inline auto fail(const char* what, const char* file, int line) ->void {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    std::abort();
+}
+
+}
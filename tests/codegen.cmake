@@ -0,0 +1,24 @@
+# compiles "codegen.cpp" to assembly and fails if one of its functions branches or calls:
+# `cmake -D COMPILER=<c++> -D SOURCE=<codegen.cpp> -D INCLUDE=<dir> -P codegen.cmake`
+execute_process(
+    COMMAND ${COMPILER} -std=c++17 -O2 -DNDEBUG -DCCAT_EXPECTED_CONTRACT=0 -I${INCLUDE} -S -o - ${SOURCE}
+    OUTPUT_VARIABLE assembly
+    ERROR_VARIABLE diagnostics
+    RESULT_VARIABLE status
+)
+if(NOT status EQUAL 0)
+    message(FATAL_ERROR "compiling ${SOURCE} failed:\n${diagnostics}")
+endif()
+
+foreach(function ccat_codegen_value ccat_codegen_error ccat_codegen_reference)
+    string(REGEX MATCH "\n${function}:[^\n]*\n(.*)" body "${assembly}")
+    if(NOT body)
+        message(FATAL_ERROR "${function} not found in the assembly")
+    endif()
+    string(FIND "${body}" ".cfi_endproc" end)
+    string(SUBSTRING "${body}" 0 ${end} body)
+    if(body MATCHES "\n[ \t]+(j[a-z]+|call|ud2)[ \t\n]")
+        message(FATAL_ERROR "${function} branches on the discriminator:\n${body}")
+    endif()
+    message(STATUS "${function}: branch-free")
+endforeach()
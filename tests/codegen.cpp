@@ -0,0 +1,22 @@
+/// @author: ccat
+
+/// @brief: compiled to assembly by "codegen.cmake": with `CCAT_EXPECTED_CONTRACT_ASSUME` the accessors must be plain
+/// loads, without a branch on the discriminator
+
+#include "expected.hpp"
+
+extern "C" {
+
+auto ccat_codegen_value(const ccat::expected<int, long>& x) ->int {
+    return *x;
+}
+
+auto ccat_codegen_error(const ccat::expected<int, long>& x) ->long {
+    return x.error();
+}
+
+auto ccat_codegen_reference(const ccat::expected<int&, long>& x) ->int {
+    return *x;
+}
+
+}
@@ -0,0 +1,90 @@
+/// @author: ccat
+
+/// @brief: what `expected` can do in constant expressions. built as C++17 and as C++20: in C++17 construction,
+/// observers and the monadic members are `constexpr` for literal types, while assignment, `emplace` and `swap`,
+/// which change the active member of the union, need `std::construct_at` and only are from C++20 on
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+using ccat::unexpected;
+
+enum class perr { empty, bad_digit, range };
+
+constexpr auto parse_port(std::string_view s) ->expected<int, perr> {
+    if (s.empty()) return unexpected(perr::empty);
+    int v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return unexpected(perr::bad_digit);
+        v = v * 10 + (c - '0');
+    }
+    if (v > 65535) return unexpected(perr::range);
+    return v;
+}
+
+constexpr auto port = parse_port("8080").value_or(80);
+static_assert(port == 8080);
+static_assert(parse_port("x").value_or(80) == 80);
+static_assert(*parse_port("1") == 1 && parse_port("1").value() == 1);
+static_assert(parse_port("99999").error() == perr::range);
+static_assert(!parse_port("").has_value() && !parse_port(""));
+
+static_assert(parse_port("12")
+    .and_then([](int x) { return expected<int, perr>(x * 2); })
+    .transform([](int x) { return x + 1; })
+    .transform_error([](perr) { return 0; })
+    .value() == 25);
+static_assert(parse_port("").or_else([](perr) { return expected<int, perr>(7); }).value() == 7);
+static_assert(parse_port("x").and_then([](int x) { return expected<int, perr>(x); }).error() == perr::bad_digit);
+
+constexpr unexpected<int> u(3);
+static_assert(u.error() == 3 && u == unexpected<int>(3));
+
+static_assert(expected<void, int>().has_value());
+static_assert(!expected<void, int>(unexpect, 1).has_value() && expected<void, int>(unexpect, 1).error() == 1);
+static_assert(expected<void, int>().and_then([] { return expected<int, int>(4); }).value() == 4);
+
+constexpr int referred = 5;
+static_assert(*expected<const int&, int>(referred) == 5);
+static_assert(expected<const int&, int>(referred).transform([](int x) { return x + 1; }).value() == 6);
+
+static_assert(expected<int, int>(expected<int, int>(9)).value() == 9, "copies are constant expressions");
+
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc)
+constexpr auto assign() ->int {
+    expected<int, perr> e(1);
+    e = unexpected(perr::range);
+    e = 5;
+    e.emplace(7);
+    expected<int, perr> f(unexpect, perr::empty);
+    e.swap(f);
+    expected<void, int> v;
+    v = unexpected(2);
+    v.emplace();
+    return f.value() + (e.has_value() ? 100 : 0) + (v.has_value() ? 10 : 0);
+}
+static_assert(assign() == 17);
+
+/// @brief: non-literal types work in C++20, as `expected` then has a `constexpr` destructor
+constexpr auto strings() ->std::size_t {
+    expected<std::string, int> s("hello");
+    auto t = s;
+    t = unexpected(3);
+    s.swap(t);
+    return t->size() + static_cast<std::size_t>(s.error()) + s.transform_error([](int e) { return std::string(e, 'x'); }).error().size();
+}
+static_assert(strings() == 11);
+#endif
+
+}
+
+auto main() ->int {
+    CCAT_CHECK(parse_port("80").value() == 80);
+}
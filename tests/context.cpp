@@ -0,0 +1,117 @@
+/// @author: ccat
+
+/// @brief: `ccat::context_error` keeps the last hops in order once its ring wraps around, copies and moves them with
+/// the error, formats them in `describe()`, and stops allocating once the per-thread pool has warmed up
+
+#include "expected_context.hpp"
+#include "check.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::size_t allocations = 0;
+
+}
+
+auto operator new(std::size_t n) ->void* {
+    ++allocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+auto operator delete(void* p) noexcept ->void {
+    std::free(p);
+}
+auto operator delete(void* p, std::size_t) noexcept ->void {
+    std::free(p);
+}
+
+namespace {
+
+using ccat::context;
+using ccat::context_error;
+using ccat::expected;
+using ccat::unexpect;
+
+using result = expected<int, context_error<int>>;
+
+const char* const messages[] = {"h0", "h1", "h2", "h3", "h4", "h5", "h6", "h7", "h8", "h9", "h10", "h11"};
+
+auto fail(std::size_t hops) ->result {
+    auto r = expected<int, int>(unexpect, 7).transform_error(context(messages[0], "a.cpp", 1, "f0"));
+    for (std::size_t i = 1; i < hops; ++i)
+        r = std::move(r).transform_error(context(messages[i], "a.cpp", static_cast<unsigned>(i + 1), "f"));
+    return r;
+}
+
+auto check_hops(const context_error<int>& e, std::size_t hops) ->void {
+    CCAT_CHECK(e.error() == 7 && e.depth() == hops);
+    const auto held = hops < context_error<int>::capacity ? hops : context_error<int>::capacity;
+    CCAT_CHECK(e.size() == held);
+    for (std::size_t i = 0; i < held; ++i) {
+        const auto& h = e.hop(i);
+        CCAT_CHECK(std::string(h.message) == messages[hops - held + i] && h.line == hops - held + i + 1);
+    }
+}
+
+}
+
+auto main() ->int {
+    static_assert(sizeof(context_error<int>) <= 2 * sizeof(void*), "the hops must live out of line");
+    static_assert(sizeof(result) <= 3 * sizeof(void*));
+
+    for (std::size_t hops = 1; hops <= 12; ++hops) {
+        const auto r = fail(hops);
+        CCAT_CHECK(!r.has_value());
+        check_hops(r.error(), hops);
+    }
+    {
+        context_error<int> bare(7);
+        CCAT_CHECK(bare.depth() == 0 && bare.size() == 0 && bare.describe().empty());
+        CCAT_CHECK(bare == context_error<int>(7));
+    }
+    {
+        const auto r = fail(3);
+        CCAT_CHECK(r.error().describe() == "h0 (a.cpp:1 in f0)\nh1 (a.cpp:2 in f)\nh2 (a.cpp:3 in f)\n");
+        const auto wrapped = fail(10);
+        CCAT_CHECK(wrapped.error().describe().rfind("... 2 earlier hop(s) dropped\nh2 (a.cpp:3 in f)\n", 0) == 0);
+    }
+    {
+        /// @note: a copy owns its own ring, a move takes the ring and leaves no hops behind
+        auto r = fail(9);
+        auto copied = r.error();
+        copied.push({"extra", "b.cpp", "g", 99});
+        check_hops(r.error(), 9);
+        CCAT_CHECK(copied.depth() == 10 && std::string(copied.hop(copied.size() - 1).message) == "extra");
+
+        auto moved = std::move(r).error();
+        check_hops(moved, 9);
+
+        context_error<int> assigned(0);
+        assigned = copied;
+        CCAT_CHECK(assigned.depth() == 10 && assigned.error() == 7);
+        assigned = std::move(moved);
+        check_hops(assigned, 9);
+        assigned = context_error<int>(1);
+        CCAT_CHECK(assigned.depth() == 0 && assigned.error() == 1);
+    }
+    {
+        /// @note: an error that crosses threads returns its ring to the pool of the thread that drops it
+        auto r = fail(4);
+        std::thread([e = std::move(r).error()] {
+            check_hops(e, 4);
+        }).join();
+    }
+    {
+        for (int i = 0; i < 4; ++i) fail(12);
+        const auto before = allocations;
+        for (int i = 0; i < 1000; ++i) {
+            const auto r = fail(12);
+            CCAT_CHECK(r.error().depth() == 12);
+        }
+        CCAT_CHECK(allocations == before);
+    }
+}
@@ -0,0 +1,36 @@
+/// @author: ccat
+
+/// @brief: the accessors in every `CCAT_EXPECTED_CONTRACT` mode. in-contract uses behave the same in each, and with
+/// `CCAT_TEST_VIOLATE` the program calls `operator*` on an error, which must trap or be diagnosed
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <string>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+/// @brief: opaque to the optimizer, so that the violation below isn't folded away
+[[gnu::noinline]] auto make(bool ok) ->expected<std::string, int> {
+    if (ok) return std::string("value");
+    return expected<std::string, int>(unexpect, 42);
+}
+
+}
+
+auto main(int argc, char**) ->int {
+    const auto ok = make(argc > 0);
+    CCAT_CHECK(*ok == "value" && ok->size() == 5);
+    const auto failed = make(argc < 0);
+    CCAT_CHECK(failed.error() == 42);
+
+    int n = 1;
+    const expected<int&, int> ref(n);
+    CCAT_CHECK(&*ref == &n);
+
+#if defined(CCAT_TEST_VIOLATE)
+    return static_cast<int>(failed->size());
+#endif
+}
@@ -0,0 +1,124 @@
+/// @author: ccat
+
+/// @brief: functions returning `expected` as coroutines. the result a caller gets must be the one the body stored,
+/// never the `E{}` placeholder the return object starts with, which is what a compiler converting the return object
+/// before running the body would hand back
+
+#include "expected_coroutine.hpp"
+#include "check.hpp"
+#include <stdexcept>
+#include <string>
+
+#if defined(CCAT_EXPECTED_HAS_COROUTINE)
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+using ccat::unexpected;
+
+/// @brief: an error whose default value, the placeholder, is distinguishable from every error the tests return.
+/// not an aggregate, see the @warning on `co_await unexpected(e)` in "expected_coroutine.hpp"
+struct error {
+    error() = default;
+    error(const char* w) : what(w) {}
+
+    std::string what = "placeholder";
+};
+
+auto parse(int x) ->expected<int, error> {
+    if (x < 0) return unexpected(error{"negative"});
+    return x * 2;
+}
+
+auto twice(int x) ->expected<int, error> {
+    const int a = co_await parse(x);
+    const int b = co_await parse(a);
+    co_return a + b;
+}
+
+auto positive(int x) ->expected<void, error> {
+    if (x <= 0) co_await unexpected(error{"not positive"});
+    co_return;
+}
+
+auto names(int x) ->expected<std::string, error> {
+    co_await positive(x);
+    const auto n = co_await twice(x);
+    co_return std::string(static_cast<std::size_t>(n), 'n');
+}
+
+/// @brief: counts the copies alive, a parameter copy lives in the coroutine frame until the frame is destroyed
+struct tracked {
+    inline static int alive = 0;
+
+    tracked() noexcept {
+        ++alive;
+    }
+    tracked(const tracked&) noexcept {
+        ++alive;
+    }
+    ~tracked() {
+        --alive;
+    }
+};
+
+auto throws(tracked, int x) ->expected<int, error> {
+    const tracked local;
+    if (x > 0) throw std::runtime_error("thrown");
+    co_return x;
+}
+
+auto throws_below(tracked t, int x) ->expected<int, error> {
+    const int y = co_await throws(t, x);
+    co_return y + 1;
+}
+
+auto depth(int n) ->expected<int, error> {
+    if (n == 0) co_return 0;
+    const int below = co_await depth(n - 1);
+    co_return below + 1;
+}
+
+}
+
+auto main() ->int {
+    const auto ok = twice(3);
+    CCAT_CHECK(ok.has_value() && *ok == 18);
+
+    const auto failed = twice(-1);
+    CCAT_CHECK(!failed.has_value());
+    CCAT_CHECK(failed.error().what != "placeholder");
+    CCAT_CHECK(failed.error().what == "negative");
+
+    CCAT_CHECK(positive(1).has_value());
+    CCAT_CHECK(!positive(0).has_value() && positive(0).error().what == "not positive");
+
+    const auto s = names(1);
+    CCAT_CHECK(s.has_value() && *s == "nnnnnn");
+    CCAT_CHECK(!names(0).has_value() && names(0).error().what == "not positive");
+
+    const auto deep = depth(64);
+    CCAT_CHECK(deep.has_value() && *deep == 64);
+
+    /// @note: an exception leaving the body reaches the caller after the frame, and the parameters in it, are destroyed
+    for (const int x : {0, 1}) {
+        bool thrown = false;
+        try {
+            const auto r = throws_below(tracked(), x);
+            CCAT_CHECK(x == 0 && r.has_value() && *r == 1);
+        }
+        catch (const std::runtime_error& e) {
+            thrown = std::string(e.what()) == "thrown";
+        }
+        CCAT_CHECK(thrown == (x == 1));
+        CCAT_CHECK(tracked::alive == 0);
+        CCAT_CHECK(ccat::detail::coroutine_arena::local().top == 0);
+    }
+}
+
+#else
+
+auto main() ->int {}
+
+#endif
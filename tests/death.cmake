@@ -0,0 +1,10 @@
+# runs a program that must die, by a signal or a non-zero exit, and optionally print `EXPECT` to stderr:
+# `cmake -D PROGRAM=<path> [-D EXPECT=<regex>] -P death.cmake`
+execute_process(COMMAND ${PROGRAM} OUTPUT_VARIABLE output ERROR_VARIABLE diagnostics RESULT_VARIABLE status)
+if(status EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} exited normally")
+endif()
+if(NOT EXPECT STREQUAL "" AND NOT diagnostics MATCHES "${EXPECT}")
+    message(FATAL_ERROR "${PROGRAM} died (${status}) without printing \"${EXPECT}\":\n${diagnostics}")
+endif()
+message(STATUS "${PROGRAM} died: ${status}")
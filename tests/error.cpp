@@ -0,0 +1,102 @@
+/// @author: ccat
+
+/// @brief: `ccat::error` holds any movable payload, inline when it fits, and moving it never throws
+
+#include "expected_error.hpp"
+#include "check.hpp"
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+
+/// @brief: a payload that describes itself neither with `message()` nor with `code()`
+struct point {
+    int x, y;
+};
+
+/// @brief: a payload `to_string` describes, found by ADL
+struct retry_after {
+    int seconds;
+};
+
+auto to_string(const retry_after& r) ->std::string {
+    return "retry after " + std::to_string(r.seconds) + "s";
+}
+
+/// @brief: an error hierarchy held by a move-only pointer
+struct error_base {
+    virtual ~error_base() = default;
+    virtual auto message() const ->std::string = 0;
+};
+struct disk_full : error_base {
+    auto message() const ->std::string override {
+        return "disk full";
+    }
+};
+
+static_assert(std::is_nothrow_move_constructible_v<ccat::error> && std::is_nothrow_move_assignable_v<ccat::error>, "moving `error` must not throw");
+static_assert(std::is_nothrow_constructible_v<ccat::error, std::error_code>, "wrapping a `std::error_code` must not allocate");
+static_assert(std::is_nothrow_constructible_v<ccat::error, std::string&&>, "wrapping a moved `std::string` must not allocate");
+static_assert(sizeof(expected<void, ccat::error>) <= 2 * sizeof(ccat::error), "`expected<void, error>` must stay small");
+
+static_assert(ccat::is_error_payload_v<point> && ccat::is_error_payload_v<retry_after> && ccat::is_error_payload_v<std::vector<int>>
+    && ccat::is_error_payload_v<std::unique_ptr<error_base>>, "any movable object-type must be a payload");
+static_assert(std::is_convertible_v<std::error_code, ccat::error> && std::is_convertible_v<std::errc, ccat::error>
+    && std::is_convertible_v<const char (&)[4], ccat::error> && std::is_convertible_v<std::string, ccat::error>,
+    "the payloads that describe themselves must convert implicitly");
+static_assert(!std::is_convertible_v<int, ccat::error> && !std::is_convertible_v<double, ccat::error> && !std::is_convertible_v<point, ccat::error>
+    && std::is_constructible_v<ccat::error, int> && std::is_constructible_v<ccat::error, point>,
+    "numbers and plain structs must be wrapped explicitly");
+static_assert(!ccat::is_error_payload_v<const point> && !ccat::is_error_payload_v<point&>, "payloads must be non-const object-types");
+
+}
+
+auto main() ->int {
+    const std::string text = "a message too long for the small string buffer of any standard library";
+    ccat::error e = text;
+    CCAT_CHECK(e.holds<std::string>() && e.message() == text);
+    ccat::error moved = std::move(e);
+    CCAT_CHECK(e.empty() && moved.message() == text);
+
+    const ccat::error code = std::make_error_code(std::errc::invalid_argument);
+    CCAT_CHECK(code.equivalent(std::errc::invalid_argument));
+    CCAT_CHECK(code.message() == std::make_error_code(std::errc::invalid_argument).message());
+
+    ccat::error p(point{1, 2});
+    CCAT_CHECK(p.get_if<point>() && p.get_if<point>()->y == 2);
+    CCAT_CHECK(!p.message().empty() && !p.code());
+    const ccat::error copy = p;
+    CCAT_CHECK(copy.get_if<point>() && copy.get_if<point>()->x == 1);
+
+    CCAT_CHECK(ccat::error(retry_after{5}).message() == "retry after 5s");
+    CCAT_CHECK(ccat::error(42).message() == "42");
+
+    ccat::error big(std::vector<int>(1000, 7));
+    ccat::error other = std::move(big);
+    CCAT_CHECK(other.get_if<std::vector<int>>() && other.get_if<std::vector<int>>()->size() == 1000);
+
+    const char* null = nullptr;
+    CCAT_CHECK(ccat::error(null).message() == "(null)");
+
+    ccat::error owned(std::unique_ptr<error_base>(new disk_full));
+    CCAT_CHECK(owned.get_if<std::unique_ptr<error_base>>() && (*owned.get_if<std::unique_ptr<error_base>>())->message() == "disk full");
+    ccat::error moved_owned = std::move(owned);
+    CCAT_CHECK(owned.empty() && moved_owned.holds<std::unique_ptr<error_base>>());
+    bool thrown = false;
+    try {
+        const ccat::error copied = moved_owned;
+        static_cast<void>(copied);
+    }
+    catch (const ccat::bad_error_copy& x) {
+        thrown = std::string(x.what()) == "ccat::bad_error_copy: the payload of this error can't be copied";
+    }
+    CCAT_CHECK(thrown && moved_owned.holds<std::unique_ptr<error_base>>());
+
+    expected<int, ccat::error> failed(ccat::unexpect, std::unique_ptr<error_base>(new disk_full));
+    const expected<int, ccat::error> taken = std::move(failed);
+    CCAT_CHECK(!taken.has_value() && taken.error().holds<std::unique_ptr<error_base>>());
+}
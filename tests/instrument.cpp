@@ -0,0 +1,53 @@
+/// @author: ccat
+
+/// @brief: with `CCAT_EXPECTED_INSTRUMENT`, `unexpected(e)` is counted at its call site, in-place constructions aren't,
+/// and threads that exit hand their block of counters to the threads started after them
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <string>
+#include <thread>
+
+namespace {
+
+using ccat::unexpected;
+
+auto failures_at(unsigned line) ->std::uint64_t {
+    std::uint64_t n = 0;
+    for (const auto& site : ccat::error_sites()) {
+        if (site.line == line) n += site.failures;
+    }
+    return n;
+}
+
+auto blocks() ->std::size_t {
+    std::size_t n = 0;
+    for (auto* block = ccat::detail::instrument_registry::get().head.load(); block; block = block->next) ++n;
+    return n;
+}
+
+}
+
+auto main() ->int {
+    const unexpected<std::string> in_place(std::in_place, "abc");
+    CCAT_CHECK(in_place.error() == "abc");
+    const unexpected<std::string> repeated(std::in_place, 3, 'x');
+    CCAT_CHECK(repeated.error() == "xxx");
+    CCAT_CHECK(ccat::error_sites().empty());
+
+    const unsigned line = __LINE__ + 1;
+    const auto counted = unexpected(std::string("counted"));
+    CCAT_CHECK(counted.error() == "counted" && failures_at(line) == 1);
+
+    const unsigned thread_line = __LINE__ + 2;
+    for (int i = 0; i < 16; ++i) {
+        std::thread([] { static_cast<void>(unexpected(1)); }).join();
+    }
+    CCAT_CHECK(failures_at(thread_line) == 16);
+#if defined(__GNUC__) || defined(__clang__)
+    for (const auto& site : ccat::error_sites()) {
+        if (site.line == thread_line) CCAT_CHECK(site.error_type == "int");
+    }
+#endif
+    CCAT_CHECK(blocks() == 2);
+}
@@ -0,0 +1,224 @@
+/// @author: ccat
+
+/// @brief: the io helpers continue after short counts and `EINTR`, split vectors longer than `IOV_MAX`, leave the
+/// caller's `iovec`s alone, give every request of a batch its own result, and map regions at any offset
+
+#include "expected_io.hpp"
+#include "check.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using ccat::read_request;
+
+/// @brief: the byte at `i` of every file and stream the tests write
+auto pattern(std::size_t i) ->char {
+    return static_cast<char>('a' + i % 23);
+}
+
+auto patterned(std::size_t size) ->std::string {
+    std::string s(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) s[i] = pattern(i);
+    return s;
+}
+
+/// @brief: an anonymous file holding `patterned(size)`
+auto temporary_file(std::size_t size) ->ccat::unique_fd {
+    char path[] = "/tmp/ccat_expected_io_XXXXXX";
+    ccat::unique_fd fd(::mkstemp(path));
+    CCAT_CHECK(fd);
+    ::unlink(path);
+    const auto content = patterned(size);
+    CCAT_CHECK(ccat::write_full(fd.get(), content.data(), content.size()).value() == size);
+    return fd;
+}
+
+/// @brief: a descriptor that scatters `source` into the buffers it is given, at most `most` bytes a call, failing
+/// every `interrupt_every`-th call with `EINTR` first. records the largest vector it was handed
+struct short_fd {
+    const std::string* source;
+    std::size_t most;
+    int interrupt_every;
+    std::size_t position = 0;
+    int calls = 0;
+    int interrupted = 0;
+    int widest = 0;
+
+    auto readv(const ::iovec* v, int n) ->::ssize_t {
+        if (n > widest) widest = n;
+        if (interrupt_every && ++calls % interrupt_every == 0) {
+            ++interrupted;
+            errno = EINTR;
+            return -1;
+        }
+        std::size_t moved = 0;
+        for (int i = 0; i < n && moved < most && position < source->size(); ++i) {
+            auto* out = static_cast<char*>(v[i].iov_base);
+            for (std::size_t j = 0; j < v[i].iov_len && moved < most && position < source->size(); ++j, ++moved) out[j] = (*source)[position++];
+        }
+        return static_cast<::ssize_t>(moved);
+    }
+};
+
+auto vectored(short_fd& fd, const ::iovec* iov, std::size_t count) ->ccat::expected<std::size_t, std::error_code> {
+    return ccat::detail::transfer_vectored(iov, count, [&fd](const ::iovec* v, int n, std::size_t) {
+        return fd.readv(v, n);
+    });
+}
+
+auto short_counts() ->void {
+    /// @note: buffers of uneven sizes, one empty, filled 7 bytes a call so that most calls end inside a buffer
+    const auto source = patterned(100);
+    std::vector<std::string> buffers = {std::string(10, '-'), std::string(), std::string(33, '-'), std::string(1, '-'), std::string(56, '-')};
+    std::vector<::iovec> iov;
+    for (auto& b : buffers) iov.push_back(::iovec{b.data(), b.size()});
+    const auto original = iov;
+
+    short_fd fd{&source, 7, 4};
+    const auto r = vectored(fd, iov.data(), iov.size());
+    CCAT_CHECK(r.value() == 100 && fd.interrupted > 0);
+    std::string joined;
+    for (const auto& b : buffers) joined += b;
+    CCAT_CHECK(joined == source);
+    for (std::size_t i = 0; i < iov.size(); ++i) CCAT_CHECK(iov[i].iov_base == original[i].iov_base && iov[i].iov_len == original[i].iov_len);
+
+    /// @note: an end of file before the buffers are full stops with the count so far
+    const auto shorter = patterned(40);
+    short_fd eof{&shorter, 7, 0};
+    for (auto& b : buffers) b.assign(b.size(), '-');
+    CCAT_CHECK(vectored(eof, iov.data(), iov.size()).value() == 40);
+    CCAT_CHECK(buffers[0] == shorter.substr(0, 10) && buffers[2] == shorter.substr(10, 30) + "---");
+
+    /// @note: an error other than `EINTR` is returned as it is
+    const auto failed = ccat::detail::transfer_vectored(iov.data(), iov.size(), [](const ::iovec*, int, std::size_t) ->::ssize_t {
+        errno = EIO;
+        return -1;
+    });
+    CCAT_CHECK(!failed.has_value() && failed.error() == std::error_code(EIO, std::system_category()));
+}
+
+auto long_vectors() ->void {
+    /// @note: three times `IOV_MAX` one-byte buffers are handed over in pieces of at most `IOV_MAX`
+    constexpr std::size_t count = 3 * CCAT_EXPECTED_IO_MAX_IOV + 5;
+    const auto source = patterned(count);
+    std::string target(count, '-');
+    std::vector<::iovec> iov;
+    for (std::size_t i = 0; i < count; ++i) iov.push_back(::iovec{&target[i], 1});
+
+    short_fd fd{&source, count, 0};
+    CCAT_CHECK(vectored(fd, iov.data(), iov.size()).value() == count);
+    CCAT_CHECK(target == source && fd.widest == CCAT_EXPECTED_IO_MAX_IOV);
+
+    /// @note: the same through a real descriptor
+    auto file = temporary_file(count);
+    target.assign(count, '-');
+    CCAT_CHECK(ccat::preadv_full(file.get(), iov.data(), iov.size(), 0).value() == count && target == source);
+}
+
+auto pipes() ->void {
+    /// @note: a pipe hands over what its writer has written so far, so the reads come up short all along
+    int ends[2];
+    CCAT_CHECK(::pipe(ends) == 0);
+    ccat::unique_fd in(ends[0]), out(ends[1]);
+    constexpr std::size_t size = 1 << 20;
+    const auto source = patterned(size);
+
+    std::thread writer([&] {
+        for (std::size_t at = 0; at < size; at += 1000) {
+            const auto n = size - at < 1000 ? size - at : std::size_t{1000};
+            CCAT_CHECK(ccat::write_full(out.get(), source.data() + at, n).value() == n);
+        }
+        out.reset();
+    });
+    std::string first(size / 2, '-'), second(size / 4, '-'), third(size / 4, '-');
+    ::iovec iov[] = {{first.data(), first.size()}, {second.data(), second.size()}};
+    CCAT_CHECK(ccat::readv_full(in.get(), iov, 2).value() == first.size() + second.size());
+    CCAT_CHECK(ccat::read_full(in.get(), third.data(), third.size()).value() == third.size());
+    writer.join();
+    CCAT_CHECK(first + second + third == source);
+
+    char past;
+    CCAT_CHECK(ccat::read_full(in.get(), &past, 1).value() == 0);
+}
+
+auto batches() ->void {
+    auto file = temporary_file(100);
+    auto other = temporary_file(50);
+    const auto source = patterned(100);
+    auto directory = ccat::open_file("/tmp", O_RDONLY | O_DIRECTORY);
+    CCAT_CHECK(directory.has_value());
+
+    /// @note: a merged run crossing the end of file, a lone request past it, and an error between the runs
+    std::vector<std::string> buffers(8, std::string(40, '-'));
+    const read_request requests[] = {
+        {file.get(), buffers[0].data(), 40, 0},
+        {file.get(), buffers[1].data(), 40, 40},
+        {file.get(), buffers[2].data(), 40, 80},
+        {file.get(), buffers[3].data(), 40, 120},
+        {directory->get(), buffers[4].data(), 40, 0},
+        {other.get(), buffers[5].data(), 40, 30},
+        {-1, buffers[6].data(), 40, 0},
+        {file.get(), buffers[7].data(), 10, 500},
+    };
+    const auto results = ccat::read_batch(requests, 8);
+    CCAT_CHECK(results.size() == 8);
+    CCAT_CHECK(results[0].value() == 40 && results[1].value() == 40 && results[2].value() == 20 && results[3].value() == 0);
+    CCAT_CHECK(buffers[0] + buffers[1] + buffers[2].substr(0, 20) == source);
+    CCAT_CHECK(results[4].error() == std::error_code(EISDIR, std::system_category()));
+    CCAT_CHECK(results[5].value() == 20 && buffers[5].substr(0, 20) == source.substr(30, 20));
+    CCAT_CHECK(results[6].error() == std::error_code(EBADF, std::system_category()));
+    CCAT_CHECK(results[7].value() == 0);
+
+    /// @note: a merged run failing as a whole is read again request by request: the buffer of the middle request
+    /// can't be written to, so only that request fails
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    void* guard = ::mmap(nullptr, page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CCAT_CHECK(guard != MAP_FAILED);
+    std::string head(30, '-'), tail(30, '-');
+    const read_request merged[] = {
+        {file.get(), head.data(), 30, 0},
+        {file.get(), guard, 30, 30},
+        {file.get(), tail.data(), 30, 60},
+    };
+    const auto retried = ccat::read_batch(merged, 3);
+    CCAT_CHECK(retried[0].value() == 30 && head == source.substr(0, 30));
+    CCAT_CHECK(retried[1].error() == std::error_code(EFAULT, std::system_category()));
+    CCAT_CHECK(retried[2].value() == 30 && tail == source.substr(60, 30));
+    ::munmap(guard, page);
+}
+
+auto mappings() ->void {
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto size = 3 * page;
+    auto file = temporary_file(size);
+    const auto source = patterned(size);
+
+    /// @note: offsets at, just past and just before a page boundary, the region starting exactly at `offset`
+    for (const std::size_t offset : {std::size_t{0}, std::size_t{1}, page - 1, page, page + 5, 2 * page + 100}) {
+        const auto length = size - offset < 200 ? size - offset : std::size_t{200};
+        const auto region = ccat::mapped_region::map(file.get(), static_cast<::off_t>(offset), length);
+        CCAT_CHECK(region.has_value() && region->size() == length);
+        CCAT_CHECK(std::string(region->begin(), region->end()) == source.substr(offset, length));
+        CCAT_CHECK(region->advise(MADV_SEQUENTIAL).has_value());
+    }
+
+    const auto negative = ccat::mapped_region::map(file.get(), -1, 10);
+    CCAT_CHECK(!negative.has_value() && negative.error() == std::error_code(EINVAL, std::system_category()));
+    const auto nothing = ccat::mapped_region::map(file.get(), 0, 0);
+    CCAT_CHECK(nothing.has_value() && nothing->empty() && nothing->data() == nullptr);
+    CCAT_CHECK(ccat::map_file("/nonexistent/ccat_expected_io").error() == std::error_code(ENOENT, std::system_category()));
+}
+
+}
+
+auto main() ->int {
+    short_counts();
+    long_vectors();
+    pipes();
+    batches();
+    mappings();
+}
@@ -0,0 +1,75 @@
+/// @author: ccat
+
+/// @brief: the storage guarantees of `expected`: a union plus a `bool`, trivial whenever `T` and `E` are,
+/// so that results are returned in registers
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <cstddef>
+#include <string>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+struct pod {
+    int a;
+    short b;
+};
+
+enum class errc : unsigned char { bad = 1 };
+
+template<typename T, typename E>
+constexpr auto expected_size() noexcept ->std::size_t {
+    constexpr std::size_t size = sizeof(T) > sizeof(E) ? sizeof(T) : sizeof(E);
+    constexpr std::size_t align = alignof(T) > alignof(E) ? alignof(T) : alignof(E);
+    return (size + 1 + align - 1) / align * align;
+}
+
+template<typename T, typename E>
+constexpr auto check_layout() noexcept ->bool {
+    using X = expected<T, E>;
+    static_assert(sizeof(X) == expected_size<T, E>(), "`expected<T, E>` must be a union plus a `bool`");
+    static_assert(alignof(X) == (alignof(T) > alignof(E) ? alignof(T) : alignof(E)), "`expected<T, E>` must not over-align");
+    static_assert(std::is_trivially_copyable_v<X>, "`expected` of trivially copyable types must be trivially copyable");
+    static_assert(std::is_trivially_destructible_v<X>, "`expected` of trivially destructible types must be trivially destructible");
+    static_assert(std::is_trivially_copy_constructible_v<X> && std::is_trivially_move_constructible_v<X>, "trivial copy and move must be kept");
+    static_assert(std::is_trivially_copy_assignable_v<X> && std::is_trivially_move_assignable_v<X>, "trivial assignment must be kept");
+    static_assert(std::is_nothrow_move_constructible_v<X> && std::is_nothrow_swappable_v<X>, "`expected` of trivial types must move without throwing");
+    return true;
+}
+
+template<typename E>
+constexpr auto check_row() noexcept ->bool {
+    return check_layout<int, E>() && check_layout<long long, E>() && check_layout<double, E>() && check_layout<char, E>()
+        && check_layout<int*, E>() && check_layout<pod, E>();
+}
+
+static_assert(check_row<int>() && check_row<char>() && check_row<errc>() && check_row<pod>() && check_row<long long>());
+
+static_assert(std::is_trivially_copyable_v<expected<void, int>>, "`expected<void, int>` must be trivially copyable");
+static_assert(sizeof(expected<void, int>) == 2 * sizeof(int), "`expected<void, int>` must be a union plus a `bool`");
+static_assert(std::is_trivially_copyable_v<expected<int&, int>>, "`expected<T&, int>` must be trivially copyable");
+
+static_assert(!std::is_trivially_copyable_v<expected<std::string, int>>, "`expected` of non-trivial types must not claim triviality");
+static_assert(!std::is_trivially_destructible_v<expected<int, std::string>>, "`expected` of non-trivial types must destroy what it holds");
+static_assert(std::is_copy_constructible_v<expected<std::string, int>> && std::is_move_constructible_v<expected<std::string, int>>);
+
+template<typename X>
+[[gnu::noinline]] auto through(X x) ->X {
+    return x;
+}
+
+}
+
+auto main() ->int {
+    const auto ok = through(expected<int, int>(42));
+    CCAT_CHECK(ok.has_value() && *ok == 42);
+    const auto err = through(expected<int, int>(unexpect, 7));
+    CCAT_CHECK(!err.has_value() && err.error() == 7);
+    const auto s = through(expected<std::string, int>(std::string(64, 'x')));
+    CCAT_CHECK(s.has_value() && s->size() == 64);
+    const auto v = through(expected<void, pod>(unexpect, pod{1, 2}));
+    CCAT_CHECK(!v.has_value() && v.error().a == 1 && v.error().b == 2);
+}
@@ -0,0 +1,26 @@
+/// @author: ccat
+
+/// @brief: `import ccat.expected;` gives the same `expected` as the header. no standard header is included here, which
+/// GCC 12 can't mix with declarations of the same entities imported from the module
+
+import ccat.expected;
+
+namespace {
+
+enum class parse_error { negative, too_large };
+
+auto parse(int x) ->ccat::expected<int, parse_error> {
+    if (x < 0) return ccat::unexpected(parse_error::negative);
+    if (x > 1000) return ccat::unexpected(parse_error::too_large);
+    return x * 2;
+}
+
+}
+
+auto main() ->int {
+    const auto r = parse(2).and_then([](int v) { return parse(v - 10); });
+    const auto p = (ccat::pipe(parse(3)) | ccat::map([](int v) { return v + 1; }) | ccat::then(parse)).run();
+    const ccat::expected<void, parse_error> none;
+    const ccat::expected<int, parse_error> failed(ccat::unexpect, parse_error::too_large);
+    return !r.has_value() && r.error() == parse_error::negative && *p == 14 && none.has_value() && failed.value_or(7) == 7 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/// @author: ccat
+
+/// @brief: niches are opt-in: no value of a built-in type is taken away from `expected`,
+/// except the null pointer of `expected<T&, E>`, which can't refer to null anyway
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <system_error>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+struct empty {};
+
+/// @brief: a handle whose `-1` is never valid, opting in with `niche_traits`
+struct handle {
+    int fd;
+};
+
+}
+
+template<>
+struct ccat::niche_traits<handle> {
+    constexpr static bool has_niche = true;
+    constexpr static auto niche() noexcept ->handle {
+        return handle{-1};
+    }
+    constexpr static auto is_niche(handle h) noexcept ->bool {
+        return h.fd == -1;
+    }
+};
+
+namespace {
+
+static_assert(std::is_default_constructible_v<expected<int*, int>> && std::is_default_constructible_v<expected<int*, empty>>,
+    "`expected<T*, E>` must be default-constructible");
+static_assert(sizeof(expected<int*, empty>) > sizeof(int*), "a pointer must keep its null value");
+static_assert(sizeof(expected<void, std::errc>) > sizeof(std::errc), "an error code must keep its zero value");
+static_assert(sizeof(expected<handle, empty>) == sizeof(handle), "an opted-in niche must hold the discriminator");
+struct final_empty final {};
+static_assert(sizeof(expected<handle, final_empty>) > sizeof(handle), "a final error type can't be an empty base, so it takes no niche");
+static_assert(sizeof(expected<int&, empty>) == sizeof(int*), "`expected<T&, Empty>` must be a single pointer");
+static_assert(std::is_nothrow_move_constructible_v<expected<void, std::error_code>>, "`expected<void, std::error_code>` must be nothrow move-constructible");
+
+static_assert(expected<int*, int>(nullptr).has_value(), "a null pointer is a value");
+static_assert(expected<int*, empty>(nullptr).has_value(), "a null pointer is a value");
+static_assert(!expected<int*, empty>(unexpect).has_value());
+static_assert(expected<int*, empty>().has_value() && *expected<int*, empty>() == nullptr);
+static_assert(!expected<void, std::errc>(unexpect, std::errc{}).has_value(), "a zero error code is an error");
+static_assert(expected<handle, empty>(handle{3}).has_value() && !expected<handle, empty>(unexpect).has_value());
+
+}
+
+auto main() ->int {
+    CCAT_CHECK(!expected<void, std::error_code>(unexpect, std::error_code{}).has_value());
+    CCAT_CHECK(!expected<void, std::error_code>(unexpect, std::make_error_code(std::errc{})).has_value());
+    CCAT_CHECK(!expected<void, std::error_condition>(unexpect, std::errc{}).has_value());
+    CCAT_CHECK(!expected<void, std::error_condition>(unexpect, std::error_condition{}).has_value());
+    CCAT_CHECK(!expected<int, std::errc>(unexpect, std::errc{}).has_value());
+
+    expected<int*, empty> p = nullptr;
+    CCAT_CHECK(p.has_value() && *p == nullptr);
+    p = ccat::unexpected<empty>(empty{});
+    CCAT_CHECK(!p.has_value());
+    p.emplace(nullptr);
+    CCAT_CHECK(p.has_value());
+
+    expected<handle, empty> h(handle{4});
+    CCAT_CHECK(h.has_value() && h->fd == 4);
+    h = ccat::unexpected<empty>(empty{});
+    CCAT_CHECK(!h.has_value());
+
+    /// @note: the empty error of a niche `expected` belongs to the object, it isn't shared between objects
+    expected<handle, empty> other(unexpect);
+    CCAT_CHECK(&h.error() != &other.error());
+    static_assert(std::is_same_v<decltype(h.error()), empty&>, "`error()` of a non-const lvalue must stay a reference");
+
+    int i = 1;
+    expected<int&, empty> r = i;
+    CCAT_CHECK(r.has_value() && &*r == &i);
+    r = ccat::unexpected<empty>(empty{});
+    CCAT_CHECK(!r.has_value());
+}
@@ -0,0 +1,93 @@
+/// @author: ccat
+
+/// @brief: `noexcept` follows `T`, `E` and the callables, so that containers of `expected` move on reallocation,
+/// and assignment and `emplace` keep the old state when constructing the new one throws
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+using ccat::unexpected;
+
+struct throwing {
+    int v = 0;
+    throwing() = default;
+    explicit throwing(int v_) : v(v_) {
+        if (v_ < 0) throw v_;
+    }
+    throwing(const throwing& other) : v(other.v) {
+        if (v < 0) throw v;
+    }
+    throwing(throwing&& other) noexcept(false) : v(other.v) {}
+    auto operator= (const throwing&) ->throwing& = default;
+    auto operator= (throwing&&) noexcept(false) ->throwing& = default;
+};
+
+template<typename T, typename E>
+constexpr auto check_noexcept() noexcept ->bool {
+    using X = expected<T, E>;
+    constexpr bool nothrow_move = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>;
+    constexpr bool nothrow_copy = std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_constructible_v<E>;
+    constexpr bool nothrow_swap = nothrow_move && std::is_nothrow_swappable_v<T> && std::is_nothrow_swappable_v<E>;
+    static_assert(std::is_nothrow_move_constructible_v<X> == nothrow_move, "moving `expected` must be as nothrow as moving `T` and `E`");
+    static_assert(std::is_nothrow_copy_constructible_v<X> == nothrow_copy, "copying `expected` must be as nothrow as copying `T` and `E`");
+    static_assert(std::is_nothrow_swappable_v<X> == nothrow_swap, "swapping `expected` must be as nothrow as moving and swapping `T` and `E`");
+    static_assert(noexcept(std::declval<X&>().emplace(std::declval<T>())) == std::is_nothrow_move_constructible_v<T>,
+        "`emplace` must be as nothrow as constructing `T`");
+    static_assert(std::is_nothrow_constructible_v<X, ccat::unexpect_t, E> == std::is_nothrow_move_constructible_v<E>,
+        "constructing the error must be as nothrow as constructing `E`");
+    return true;
+}
+
+template<typename E>
+constexpr auto check_row() noexcept ->bool {
+    return check_noexcept<int, E>() && check_noexcept<std::string, E>() && check_noexcept<std::vector<int>, E>() && check_noexcept<throwing, E>();
+}
+
+static_assert(check_row<int>() && check_row<std::string>() && check_row<throwing>());
+
+static_assert(std::is_nothrow_move_constructible_v<expected<void, std::string>> && !std::is_nothrow_move_constructible_v<expected<void, throwing>>);
+static_assert(std::is_nothrow_move_constructible_v<expected<int&, std::string>> && !std::is_nothrow_move_constructible_v<expected<int&, throwing>>);
+
+constexpr auto nothrow_f = [](int x) noexcept { return expected<int, std::string>(x); };
+constexpr auto throwing_f = [](int x) { return expected<int, std::string>(x); };
+static_assert(noexcept(std::declval<expected<int, std::string>>().and_then(nothrow_f)), "`and_then` must be as nothrow as `f` and moving the error");
+static_assert(!noexcept(std::declval<expected<int, std::string>>().and_then(throwing_f)));
+static_assert(!noexcept(std::declval<const expected<int, std::string>&>().and_then(nothrow_f)), "copying a `std::string` may throw");
+constexpr auto nothrow_g = [](int x) noexcept { return x; };
+constexpr auto throwing_g = [](int x) { return x; };
+static_assert(noexcept(std::declval<expected<int, int>>().transform(nothrow_g)), "`transform` must be as nothrow as `f`");
+static_assert(!noexcept(std::declval<expected<int, int>>().transform(throwing_g)));
+
+}
+
+auto main() ->int {
+    std::vector<expected<std::string, std::string>> v;
+    v.emplace_back(std::string(100, 'a'));
+    const auto* data = v.front()->data();
+    v.reserve(v.capacity() + 1);
+    CCAT_CHECK(v.front()->data() == data);
+
+    expected<throwing, int> x(unexpect, 3);
+    try {
+        x.emplace(-1);
+        CCAT_CHECK(false);
+    }
+    catch (int) {}
+    CCAT_CHECK(!x.has_value() && x.error() == 3);
+
+    expected<int, throwing> y(5);
+    ccat::unexpected<throwing> bad(throwing{});
+    bad.error().v = -1;
+    try {
+        y = bad;
+        CCAT_CHECK(false);
+    }
+    catch (int) {}
+    CCAT_CHECK(y.has_value() && *y == 5);
+}
@@ -0,0 +1,113 @@
+/// @author: ccat
+
+/// @brief: `when_all` and `parallel_collect` with tasks returning values, references and `expected<void, E>`, reporting
+/// the error of the first task in task order to fail whatever the order they fail in
+
+#include "expected_parallel.hpp"
+#include "check.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+}
+
+auto main() ->int {
+    ccat::thread_pool pool(4);
+    std::atomic<int> ran{0};
+
+    const auto mixed = ccat::when_all(pool,
+        [] { return expected<int, std::string>(1); },
+        [&ran] { ++ran; return expected<void, std::string>(); },
+        [] { return expected<std::string, std::string>("two"); }
+    );
+    static_assert(std::is_same_v<ccat::remove_cvref_t<decltype(*mixed)>, std::tuple<int, std::string>>, "`void` tasks must contribute no value");
+    CCAT_CHECK(mixed.has_value() && std::get<0>(*mixed) == 1 && std::get<1>(*mixed) == "two" && ran == 1);
+
+    const auto voids = ccat::when_all(pool,
+        [&ran] { ++ran; return expected<void, std::string>(); },
+        [] { return expected<void, std::string>(unexpect, "failed"); }
+    );
+    CCAT_CHECK(!voids.has_value() && voids.error() == "failed");
+
+    std::vector<int> inputs(1000);
+    for (int i = 0; i < 1000; ++i) inputs[static_cast<std::size_t>(i)] = i;
+
+    std::atomic<long> sum{0};
+    const auto all = ccat::parallel_collect(pool, inputs, [&sum](int x) {
+        sum += x;
+        return expected<void, std::string>();
+    });
+    static_assert(std::is_same_v<ccat::remove_cvref_t<decltype(all)>, expected<void, std::string>>, "a `void` task must collect into `expected<void, E>`");
+    CCAT_CHECK(all.has_value() && sum == 999 * 1000 / 2);
+
+    const auto failed = ccat::parallel_collect(pool, inputs, [](int x) {
+        if (x == 500) return expected<void, std::string>(unexpect, "500");
+        return expected<void, std::string>();
+    });
+    CCAT_CHECK(!failed.has_value() && failed.error() == "500");
+
+    const auto squares = ccat::parallel_collect(pool, inputs, [](int x) { return expected<long, std::string>(long(x) * x); });
+    CCAT_CHECK(squares.has_value() && squares->size() == 1000 && (*squares)[999] == 999L * 999);
+
+    CCAT_CHECK(ccat::parallel_collect(pool, std::vector<int>{}, [](int) { return expected<void, std::string>(); }).has_value());
+
+    {
+        /// @note: the later task fails first in time, the earlier one's error is still the one reported
+        const auto ordered = ccat::when_all(pool,
+            [] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return expected<int, std::string>(unexpect, "first");
+            },
+            [] { return expected<int, std::string>(unexpect, "second"); }
+        );
+        CCAT_CHECK(!ordered.has_value() && ordered.error() == "first");
+
+        for (int round = 0; round < 20; ++round) {
+            const auto lowest = ccat::parallel_collect(pool, inputs, [](int x) {
+                if (x == 900) return expected<int, std::string>(unexpect, "900");
+                if (x == 100) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    return expected<int, std::string>(unexpect, "100");
+                }
+                return expected<int, std::string>(x);
+            });
+            CCAT_CHECK(!lowest.has_value() && lowest.error() == "100");
+        }
+
+        /// @note: every call after a failed first input may stop early, and never changes the error reported
+        const auto skipped = ccat::parallel_collect(pool, inputs, [](int x, const ccat::cancel_token& token) {
+            if (x == 0) return expected<void, std::string>(unexpect, "0");
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            if (token.cancelled()) return expected<void, std::string>(unexpect, "cancelled");
+            return expected<void, std::string>();
+        });
+        CCAT_CHECK(!skipped.has_value() && skipped.error() == "0");
+    }
+    {
+        /// @note: `expected<T&, E>` tasks hand back the referred objects themselves
+        int a = 1, b = 2;
+        const auto refs = ccat::when_all(pool,
+            [&a] { return expected<int&, std::string>(a); },
+            [&b] { return expected<const int&, std::string>(b); },
+            [] { return expected<int, std::string>(3); }
+        );
+        static_assert(std::is_same_v<ccat::remove_cvref_t<decltype(*refs)>, std::tuple<int&, const int&, int>>, "references must be kept");
+        CCAT_CHECK(refs.has_value() && &std::get<0>(*refs) == &a && &std::get<1>(*refs) == &b && std::get<2>(*refs) == 3);
+
+        std::vector<int> objects(100, 0);
+        const auto collected = ccat::parallel_collect(pool, inputs, [&objects](int x) {
+            return expected<int&, std::string>(objects[static_cast<std::size_t>(x) % objects.size()]);
+        });
+        static_assert(std::is_same_v<ccat::remove_cvref_t<decltype(*collected)>, std::vector<std::reference_wrapper<int>>>,
+            "references must be collected as `std::reference_wrapper`");
+        CCAT_CHECK(collected.has_value() && collected->size() == 1000 && &(*collected)[123].get() == &objects[23]);
+    }
+}
@@ -0,0 +1,121 @@
+/// @author: ccat
+
+/// @brief: `ccat::pipe` runs the same steps as the eager members, but moves the error once into the result
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <string>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+using ccat::unexpected;
+
+struct counted_error {
+    inline static int copies = 0;
+    inline static int moves = 0;
+
+    std::string what;
+
+    explicit counted_error(std::string what_) : what(std::move(what_)) {}
+    counted_error(const counted_error& other) : what(other.what) {
+        ++copies;
+    }
+    counted_error(counted_error&& other) noexcept : what(std::move(other.what)) {
+        ++moves;
+    }
+    auto operator= (const counted_error&) ->counted_error& = default;
+    auto operator= (counted_error&&) noexcept ->counted_error& = default;
+
+    static auto reset() noexcept ->void {
+        copies = moves = 0;
+    }
+};
+
+using result = expected<int, counted_error>;
+
+auto source(bool ok) ->result {
+    if (ok) return 1;
+    return result(unexpect, "source failed");
+}
+
+auto increment(int x) ->result {
+    return x + 1;
+}
+
+auto fail_at_three(int x) ->result {
+    if (x == 3) return result(unexpect, "three");
+    return x;
+}
+
+auto check_positive(int x) ->expected<void, counted_error> {
+    if (x <= 0) return expected<void, counted_error>(unexpect, "not positive");
+    return {};
+}
+
+}
+
+auto main() ->int {
+    {
+        const result r = ccat::pipe(source(true)) | ccat::then(increment) | ccat::map([](int x) { return x * 2; }) | ccat::then(increment);
+        CCAT_CHECK(r.has_value() && *r == 5);
+    }
+    {
+        auto s = source(false);
+        counted_error::reset();
+        const result r = ccat::pipe(std::move(s)) | ccat::then(increment) | ccat::map([](int x) { return x * 2; }) | ccat::then(increment);
+        CCAT_CHECK(!r.has_value() && r.error().what == "source failed");
+        /// @note: an rvalue source moves into the pipeline, along with it at each `|`, and into the result, but is never copied
+        CCAT_CHECK(counted_error::copies == 0 && counted_error::moves == 5);
+    }
+    {
+        const auto s = source(false);
+        counted_error::reset();
+        const result r = ccat::pipe(s) | ccat::then(increment) | ccat::then(increment);
+        CCAT_CHECK(!r.has_value() && counted_error::copies == 1 && counted_error::moves == 0);
+    }
+    {
+        const auto s = source(true);
+        counted_error::reset();
+        const result r = ccat::pipe(s) | ccat::then(increment) | ccat::then(increment) | ccat::then(fail_at_three) | ccat::then(increment);
+        CCAT_CHECK(!r.has_value() && r.error().what == "three");
+        CCAT_CHECK(counted_error::copies == 0 && counted_error::moves == 1);
+    }
+    {
+        /// @note: the eager chain rebuilds the error at every step
+        auto s = source(false);
+        counted_error::reset();
+        const result r = std::move(s).and_then(increment).and_then(increment).and_then(increment);
+        CCAT_CHECK(!r.has_value() && counted_error::moves == 3);
+    }
+    {
+        int seen = 0;
+        const expected<int, counted_error> r = ccat::pipe(source(true)) | ccat::then(increment) | ccat::then(check_positive)
+            | ccat::map([&seen] { seen = 1; }) | ccat::map([] { return 7; });
+        CCAT_CHECK(r.has_value() && *r == 7 && seen == 1);
+
+        const expected<void, counted_error> v = ccat::pipe(source(true)) | ccat::map([](int x) { return x - 1; }) | ccat::then(check_positive);
+        CCAT_CHECK(!v.has_value() && v.error().what == "not positive");
+
+        const expected<int, counted_error> w = ccat::pipe(check_positive(2)) | ccat::map([] { return 3; }) | ccat::then(increment);
+        CCAT_CHECK(w.has_value() && *w == 4);
+    }
+    {
+        /// @note: a pipeline owns an rvalue source, so it may outlive the full-expression that made it
+        auto p = ccat::pipe(source(true)) | ccat::map([](int x) { return x + 41; });
+        const result r = std::move(p).run();
+        CCAT_CHECK(r.has_value() && *r == 42);
+
+        auto q = ccat::pipe(source(false)) | ccat::then(increment);
+        counted_error::reset();
+        const result e = std::move(q).run();
+        CCAT_CHECK(!e.has_value() && e.error().what == "source failed" && counted_error::copies == 0);
+    }
+    {
+        int x = 1;
+        expected<int&, counted_error> ref(x);
+        const expected<int, counted_error> r = ccat::pipe(ref) | ccat::map([](int& y) { return ++y; });
+        CCAT_CHECK(r.has_value() && *r == 2 && x == 2);
+    }
+}
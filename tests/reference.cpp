@@ -0,0 +1,119 @@
+/// @author: ccat
+
+/// @brief: `expected<T&, E>` refers to an object instead of holding one: assigning rebinds it, and every accessor
+/// and monadic member reaches the referred object itself
+
+#include "expected.hpp"
+#include "check.hpp"
+#include <string>
+#include <type_traits>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+using ccat::unexpected;
+
+struct base {
+    int id;
+};
+struct derived : base {
+    explicit derived(int id_) : base{id_} {}
+};
+
+}
+
+auto main() ->int {
+    {
+        /// @note: assigning an lvalue, another `expected` or `emplace` rebinds, the referred objects are left untouched
+        int a = 1, b = 2, c = 3;
+        expected<int&, std::string> r = a;
+        CCAT_CHECK(&*r == &a);
+        r = b;
+        CCAT_CHECK(&*r == &b && a == 1 && b == 2);
+        const expected<int&, std::string> other = c;
+        r = other;
+        CCAT_CHECK(&*r == &c && a == 1 && b == 2);
+        CCAT_CHECK(&r.emplace(a) == &a && b == 2 && c == 3);
+        *r = 10;
+        CCAT_CHECK(a == 10 && b == 2 && c == 3);
+
+        r = unexpected(std::string("gone"));
+        CCAT_CHECK(!r.has_value() && r.error() == "gone" && a == 10);
+        r = b;
+        CCAT_CHECK(r.has_value() && &*r == &b);
+    }
+    {
+        int x = 4;
+        const expected<int&, std::string> ok = x;
+        const expected<int&, std::string> failed(unexpect, "failed");
+        CCAT_CHECK(ok.value_or(9) == 4 && failed.value_or(9) == 9);
+        static_assert(std::is_same_v<decltype(ok.value_or(9)), int>, "`value_or` must return a copy");
+
+        CCAT_CHECK(&ok.value() == &x);
+        bool thrown = false;
+        try {
+            static_cast<void>(failed.value());
+        }
+        catch (const ccat::bad_expected_access<std::string>& e) {
+            thrown = e.error() == "failed";
+        }
+        CCAT_CHECK(thrown);
+
+        int calls = 0;
+        const auto chained = failed.and_then([&calls](int& y) {
+            ++calls;
+            return expected<int, std::string>(y);
+        });
+        CCAT_CHECK(!chained.has_value() && chained.error() == "failed" && calls == 0);
+        const auto recovered = failed.or_else([&x](const std::string&) {
+            return expected<int&, std::string>(x);
+        });
+        CCAT_CHECK(recovered.has_value() && &*recovered == &x);
+        const auto renamed = failed.transform_error([](const std::string& e) {
+            return e.size();
+        });
+        CCAT_CHECK(!renamed.has_value() && renamed.error() == 6);
+        const auto kept = ok.transform_error([](const std::string& e) {
+            return e.size();
+        });
+        CCAT_CHECK(kept.has_value() && &*kept == &x);
+    }
+    {
+        /// @note: `transform` on an lvalue and a const lvalue source reaches the referred object, and keeps a returned
+        /// reference as a reference
+        base object{7};
+        expected<base&, std::string> r = object;
+        const expected<base&, std::string> cr = object;
+
+        auto member = r.transform([](base& o) ->int& { return o.id; });
+        static_assert(std::is_same_v<decltype(member), expected<int&, std::string>>, "an lvalue result must stay a reference");
+        CCAT_CHECK(&*member == &object.id);
+        *member = 8;
+        CCAT_CHECK(object.id == 8);
+
+        auto from_const = cr.transform([](base& o) ->int& { return o.id; });
+        CCAT_CHECK(&*from_const == &object.id);
+
+        const auto copied = cr.transform([](const base& o) { return o.id + 1; });
+        static_assert(std::is_same_v<decltype(copied), const expected<int, std::string>>, "a prvalue result must be held by value");
+        CCAT_CHECK(*copied == 9);
+
+        const expected<base&, std::string> failed(unexpect, "none");
+        const auto skipped = failed.transform([](base& o) ->int& { return o.id; });
+        CCAT_CHECK(!skipped.has_value() && skipped.error() == "none");
+    }
+    {
+        /// @note: a reference to a derived object converts to a reference to its base, a const one can't be assigned through
+        derived d(5);
+        const expected<derived&, std::string> rd = d;
+        const expected<base&, std::string> rb = rd;
+        CCAT_CHECK(&*rb == static_cast<base*>(&d) && rb->id == 5);
+
+        const int k = 6;
+        expected<const int&, std::string> rk = k;
+        CCAT_CHECK(&*rk == &k);
+        static_assert(std::is_same_v<decltype(*rk), const int&>, "the constness of `T` must be kept");
+        static_assert(!std::is_constructible_v<expected<int&, std::string>, int&&>, "an rvalue must not be bound");
+    }
+}
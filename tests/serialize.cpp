@@ -0,0 +1,182 @@
+/// @author: ccat
+
+/// @brief: records written by `serialize_all` to a file and viewed in place where the file is mapped,
+/// and the errors `from` and `deserialize` report for buffers that don't hold a record
+
+#include "expected_serialize.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CCAT_TEST_HAS_MMAP 1
+#endif
+#endif
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using record = expected<std::uint64_t, std::uint32_t>;
+using layout = ccat::wire_layout<std::uint64_t, std::uint32_t>;
+
+/// @brief: a payload with padding after `kind`, which must not be serialized
+struct padded {
+    std::uint8_t kind;
+    std::uint32_t value;
+};
+/// @brief: a payload of `double`s, declared free of padding
+struct point {
+    double x, y;
+};
+
+}
+
+template<>
+struct ccat::is_padding_free<point> : std::true_type {};
+
+namespace {
+
+static_assert(!ccat::is_padding_free<padded>::value && ccat::is_padding_free<std::uint64_t>::value && ccat::is_padding_free<double>::value
+    && ccat::is_padding_free<std::errc>::value, "only types without padding may be copied byte for byte");
+
+auto same(const record& a, const record& b) ->bool {
+    return a.has_value() == b.has_value() && (a.has_value() ? *a == *b : a.error() == b.error());
+}
+
+/// @brief: the bytes of `file`, mapped read-only when the platform can, read into an aligned buffer otherwise
+class file_bytes {
+public:
+    file_bytes(std::FILE* file, std::size_t size) : size_(size) {
+#if defined(CCAT_TEST_HAS_MMAP)
+        map_ = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, ::fileno(file), 0);
+        CCAT_CHECK(map_ != MAP_FAILED);
+#else
+        copy_.reset(new std::uint64_t[size / sizeof(std::uint64_t) + 1]);
+        std::rewind(file);
+        CCAT_CHECK(std::fread(copy_.get(), 1, size, file) == size);
+#endif
+    }
+    file_bytes(const file_bytes&) = delete;
+    auto operator= (const file_bytes&) ->file_bytes& = delete;
+    ~file_bytes() {
+#if defined(CCAT_TEST_HAS_MMAP)
+        ::munmap(map_, size_);
+#endif
+    }
+
+    auto data() const noexcept ->const std::byte* {
+#if defined(CCAT_TEST_HAS_MMAP)
+        return static_cast<const std::byte*>(map_);
+#else
+        return reinterpret_cast<const std::byte*>(copy_.get());
+#endif
+    }
+    auto size() const noexcept ->std::size_t {
+        return size_;
+    }
+private:
+    std::size_t size_;
+#if defined(CCAT_TEST_HAS_MMAP)
+    void* map_ = nullptr;
+#else
+    std::unique_ptr<std::uint64_t[]> copy_;
+#endif
+};
+
+auto round_trip() ->void {
+    std::vector<record> records;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        if (i % 7 == 3)
+            records.emplace_back(unexpect, i);
+        else
+            records.emplace_back(std::uint64_t{i} << 33 | i);
+    }
+
+    std::vector<std::byte> bytes(records.size() * layout::size);
+    const auto written = ccat::serialize_all(records.begin(), records.end(), bytes.data(), bytes.size());
+    CCAT_CHECK(written.has_value() && *written == bytes.size());
+
+    std::FILE* file = std::tmpfile();
+    CCAT_CHECK(file != nullptr);
+    CCAT_CHECK(std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    CCAT_CHECK(std::fflush(file) == 0);
+    {
+        const file_bytes mapped(file, bytes.size());
+        const auto view = ccat::expected_array_view<std::uint64_t, std::uint32_t>::from(mapped.data(), mapped.size());
+        CCAT_CHECK(view.has_value() && view->size() == records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const auto x = (*view)[i];
+            CCAT_CHECK(x.has_value() == records[i].has_value());
+            CCAT_CHECK(x.has_value() ? *x == *records[i] : x.error() == records[i].error());
+            CCAT_CHECK(same(x.get(), records[i]));
+        }
+
+        std::vector<record> copied;
+        view->copy_to(std::back_inserter(copied));
+        CCAT_CHECK(std::equal(copied.begin(), copied.end(), records.begin(), records.end(), same));
+    }
+    std::fclose(file);
+}
+
+auto errors() ->void {
+    alignas(layout::align) std::byte buffer[2 * layout::size + layout::align] = {};
+    CCAT_CHECK(ccat::serialize_into(record(42), buffer, sizeof(buffer)).has_value());
+
+    using view = ccat::expected_view<std::uint64_t, std::uint32_t>;
+    using array_view = ccat::expected_array_view<std::uint64_t, std::uint32_t>;
+    CCAT_CHECK(view::from(buffer, layout::size).has_value());
+
+    CCAT_CHECK(view::from(buffer, layout::size - 1).error() == std::errc::message_size);
+    CCAT_CHECK(array_view::from(buffer, layout::size - 1).error() == std::errc::message_size);
+    CCAT_CHECK((ccat::deserialize<std::uint64_t, std::uint32_t>(buffer, layout::size - 1).error() == std::errc::message_size));
+
+    CCAT_CHECK(view::from(buffer + 1, layout::size).error() == std::errc::bad_address);
+    CCAT_CHECK(array_view::from(buffer + 1, layout::size).error() == std::errc::bad_address);
+
+    buffer[layout::size] = std::byte{0x7f};
+    CCAT_CHECK(view::from(buffer + layout::size, layout::size).error() == std::errc::illegal_byte_sequence);
+    CCAT_CHECK(array_view::from(buffer, 2 * layout::size).error() == std::errc::illegal_byte_sequence);
+    CCAT_CHECK((ccat::deserialize<std::uint64_t, std::uint32_t>(buffer + layout::size, layout::size).error() == std::errc::illegal_byte_sequence));
+
+    /// @note: a record of another wire version is rejected too
+    buffer[0] = static_cast<std::byte>((ccat::wire_version + 1) << 4 | 0x1);
+    CCAT_CHECK(view::from(buffer, layout::size).error() == std::errc::illegal_byte_sequence);
+
+    CCAT_CHECK(ccat::serialize_into(record(1), buffer, layout::size - 1).error() == std::errc::no_buffer_space);
+}
+
+/// @brief: the bytes of a record depend only on the value, not on what the memory held before
+auto deterministic() ->void {
+    alignas(8) std::byte dirty[layout::size];
+    alignas(8) std::byte clean[layout::size];
+    std::memset(dirty, 0xa5, sizeof(dirty));
+    std::memset(clean, 0, sizeof(clean));
+    CCAT_CHECK(ccat::serialize_into(record(unexpect, 7u), dirty, sizeof(dirty)).has_value());
+    CCAT_CHECK(ccat::serialize_into(record(unexpect, 7u), clean, sizeof(clean)).has_value());
+    CCAT_CHECK(std::memcmp(dirty, clean, layout::size) == 0);
+
+    using point_layout = ccat::wire_layout<point, std::errc>;
+    alignas(point_layout::align) std::byte bytes[point_layout::size];
+    CCAT_CHECK((ccat::serialize_into(expected<point, std::errc>(point{1.5, -2.0}), bytes, sizeof(bytes)).has_value()));
+    const auto back = ccat::deserialize<point, std::errc>(bytes, sizeof(bytes));
+    CCAT_CHECK(back.has_value() && back->has_value() && (**back).x == 1.5 && (**back).y == -2.0);
+}
+
+}
+
+auto main() ->int {
+    round_trip();
+    errors();
+    deterministic();
+}
@@ -0,0 +1,138 @@
+/// @author: ccat
+
+/// @brief: `error_list` keeps its first errors inline and spills the rest to the heap, copies and moves in both states,
+/// and appends one of its own errors when full; `validate` collects the values or every error in argument order
+
+#include "expected_validate.hpp"
+#include "check.hpp"
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace {
+
+using ccat::error_list;
+using ccat::expected;
+using ccat::unexpect;
+
+using list = error_list<std::string, 2>;
+
+/// @brief: long enough to live on the heap, so reading one destroyed is caught by the sanitizers as well
+auto name(int i) ->std::string {
+    return "error number " + std::to_string(i) + " of a list that outgrows its inline storage";
+}
+
+/// @brief: whether the first `count` errors are the ones `filled` appends, and there are `count + extra` of them
+auto holds(const list& l, int count, int extra = 0) ->bool {
+    if (l.size() != static_cast<std::size_t>(count + extra)) return false;
+    for (int i = 0; i < count; ++i) {
+        if (l[i] != name(i)) return false;
+    }
+    return true;
+}
+
+auto filled(int count) ->list {
+    list l;
+    for (int i = 0; i < count; ++i) l.push_back(name(i));
+    return l;
+}
+
+/// @brief: counts live objects and throws from the copy constructor once armed
+struct fragile {
+    static inline int alive = 0;
+    static inline int copies_left = -1;
+    int id;
+
+    explicit fragile(int id_) : id(id_) { ++alive; }
+    fragile(const fragile& other) : id(other.id) {
+        if (copies_left == 0) throw 0;
+        if (copies_left > 0) --copies_left;
+        ++alive;
+    }
+    ~fragile() { --alive; }
+};
+
+}
+
+auto main() ->int {
+    {
+        list l = filled(2);
+        CCAT_CHECK(!l.spilled() && l.capacity() == 2 && holds(l, 2));
+        l.push_back(name(2));
+        CCAT_CHECK(l.spilled() && l.capacity() == 4 && holds(l, 3));
+        for (int i = 3; i < 9; ++i) l.push_back(name(i));
+        CCAT_CHECK(l.capacity() == 16 && holds(l, 9));
+        l.clear();
+        CCAT_CHECK(l.empty() && l.spilled());
+    }
+    {
+        /// @note: appending an error of the list itself while it is full, inline and spilled
+        for (const int count : {2, 4, 8}) {
+            list l = filled(count);
+            CCAT_CHECK(l.size() == l.capacity());
+            l.push_back(l[0]);
+            l.emplace_back(l[count - 1]);
+            CCAT_CHECK(holds(l, count, 2));
+            CCAT_CHECK(l[count] == name(0) && l[count + 1] == name(count - 1));
+        }
+    }
+    {
+        for (const int count : {0, 1, 2, 3, 9}) {
+            const list source = filled(count);
+            list copy = source;
+            CCAT_CHECK(holds(copy, count) && holds(source, count) && copy.spilled() == (count > 2));
+
+            list moved = std::move(copy);
+            CCAT_CHECK(holds(moved, count) && copy.empty());
+
+            list assigned = filled(5);
+            assigned = source;
+            CCAT_CHECK(holds(assigned, count));
+            list move_assigned = filled(1);
+            move_assigned = std::move(assigned);
+            CCAT_CHECK(holds(move_assigned, count) && assigned.empty());
+            assigned.push_back(name(0));
+            CCAT_CHECK(holds(assigned, 1));
+        }
+    }
+    {
+        /// @note: a throw while growing leaves the list as it was, with nothing leaked
+        {
+            error_list<fragile, 2> l;
+            l.emplace_back(0);
+            l.emplace_back(1);
+            const fragile extra(2);
+            fragile::copies_left = 0;
+            bool thrown = false;
+            try {
+                l.push_back(extra);
+            }
+            catch (int) {
+                thrown = true;
+            }
+            fragile::copies_left = -1;
+            CCAT_CHECK(thrown && l.size() == 2 && !l.spilled() && l[0].id == 0 && l[1].id == 1);
+            CCAT_CHECK(fragile::alive == 3);
+        }
+        CCAT_CHECK(fragile::alive == 0);
+    }
+    {
+        using int_result = expected<int, std::string>;
+        using void_result = expected<void, std::string>;
+        const void_result ok;
+        const void_result bad(unexpect, "bad void");
+
+        auto all = ccat::validate(int_result(1), ok, int_result(3), void_result());
+        static_assert(std::is_same_v<decltype(all)::value_type, std::tuple<int, int>>, "`void` arguments must contribute no value");
+        CCAT_CHECK(all.has_value() && *all == std::make_tuple(1, 3));
+
+        auto some = ccat::validate(int_result(unexpect, "first"), ok, bad, int_result(4), int_result(unexpect, "last"));
+        CCAT_CHECK(!some.has_value() && some.error().size() == 3 && !some.error().spilled());
+        CCAT_CHECK(some.error()[0] == "first" && some.error()[1] == "bad void" && some.error()[2] == "last");
+
+        /// @note: an inline capacity smaller than the number of failures spills
+        auto spilled = ccat::validate<1>(bad, int_result(unexpect, "second"), bad);
+        CCAT_CHECK(!spilled.has_value() && spilled.error().spilled() && spilled.error().size() == 3);
+        CCAT_CHECK(spilled.error()[0] == "bad void" && spilled.error()[1] == "second" && spilled.error()[2] == "bad void");
+    }
+}
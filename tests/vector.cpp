@@ -0,0 +1,144 @@
+/// @author: ccat
+
+/// @brief: `ccat::expected_vector` keeps the values, the errors and the bitmap in step across word boundaries,
+/// and is left as it was when the error type throws
+
+#include "expected_vector.hpp"
+#include "check.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::expected_vector;
+using ccat::unexpect;
+
+/// @brief: element `i` fails when `fails(i)` is true, with the error `"e" + i`
+template<typename Fails>
+auto make(std::size_t n, Fails fails) ->expected_vector<int, std::string> {
+    expected_vector<int, std::string> v;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (fails(i)) v.emplace_back(unexpect, "e" + std::to_string(i));
+        else v.push_back(static_cast<int>(i));
+    }
+    return v;
+}
+
+template<typename Fails>
+auto check_against_loop(std::size_t n, Fails fails) ->void {
+    const auto v = make(n, fails);
+    CCAT_CHECK(v.size() == n);
+
+    std::vector<int> values;
+    std::size_t errors = 0;
+    std::size_t first = n;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto x = v.get(i);
+        CCAT_CHECK(x.has_value() == !fails(i) && v.has_value(i) == !fails(i));
+        if (fails(i)) {
+            CCAT_CHECK(x.error() == "e" + std::to_string(i) && v.error(i) == x.error());
+            if (first == n) first = i;
+            ++errors;
+        }
+        else {
+            CCAT_CHECK(*x == static_cast<int>(i) && v.value(i) == *x);
+            values.push_back(*x);
+        }
+    }
+
+    std::vector<int> seen;
+    for (auto it = v.values().begin(); it != v.values().end(); ++it) {
+        CCAT_CHECK(*it == static_cast<int>(it.index()));
+        seen.push_back(*it);
+    }
+    CCAT_CHECK(seen == values);
+    CCAT_CHECK(v.count_errors() == errors && v.all_values() == (errors == 0));
+    CCAT_CHECK(v.first_error_index() == first);
+    CCAT_CHECK(first == n ? v.first_error() == nullptr : *v.first_error() == "e" + std::to_string(first));
+}
+
+struct throws_on_copy {
+    inline static bool armed = false;
+
+    int id;
+
+    explicit throws_on_copy(int id_) : id(id_) {}
+    throws_on_copy(const throws_on_copy& other) : id(other.id) {
+        if (armed) throw std::runtime_error("copy");
+    }
+    throws_on_copy(throws_on_copy&&) noexcept = default;
+    auto operator= (const throws_on_copy&) ->throws_on_copy& = default;
+    auto operator= (throws_on_copy&&) noexcept ->throws_on_copy& = default;
+};
+
+}
+
+auto main() ->int {
+    for (const std::size_t n : {0, 1, 63, 64, 65, 127, 128, 129, 200}) {
+        check_against_loop(n, [](std::size_t) { return false; });
+        check_against_loop(n, [](std::size_t) { return true; });
+        /// @note: leading, trailing and consecutive failures, some straddling a word boundary
+        check_against_loop(n, [](std::size_t i) { return i < 3; });
+        check_against_loop(n, [n](std::size_t i) { return i + 3 >= n; });
+        check_against_loop(n, [](std::size_t i) { return i >= 62 && i < 67; });
+        check_against_loop(n, [](std::size_t i) { return i % 64 == 63 || i % 64 == 0; });
+        check_against_loop(n, [](std::size_t i) { return i % 3 != 0; });
+    }
+    {
+        auto v = make(130, [](std::size_t i) { return i % 5 == 4; });
+        const auto copied = v.to_vector();
+        CCAT_CHECK(copied.size() == 130 && v.size() == 130 && v.error(4) == "e4");
+        const auto moved = std::move(v).to_vector();
+        CCAT_CHECK(moved.size() == 130 && v.empty() && v.count_errors() == 0);
+        for (std::size_t i = 0; i < 130; ++i) {
+            CCAT_CHECK(copied[i].has_value() == moved[i].has_value());
+            if (i % 5 == 4) CCAT_CHECK(copied[i].error() == "e" + std::to_string(i) && moved[i].error() == copied[i].error());
+            else CCAT_CHECK(*copied[i] == static_cast<int>(i) && *moved[i] == *copied[i]);
+        }
+
+        const expected_vector<int, std::string> round_trip(moved);
+        CCAT_CHECK(round_trip.size() == 130 && round_trip.count_errors() == 26 && round_trip.first_error_index() == 4);
+    }
+    {
+        /// @note: a throwing error constructor leaves the vector as it was, at a word boundary and within a word
+        for (const std::size_t n : {63, 64, 65}) {
+            expected_vector<int, throws_on_copy> v;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (i % 2) v.emplace_back(unexpect, static_cast<int>(i));
+                else v.push_back(static_cast<int>(i));
+            }
+            const throws_on_copy e(-1);
+            const expected<int, throws_on_copy> x(unexpect, e);
+            throws_on_copy::armed = true;
+            int thrown = 0;
+            try {
+                v.push_back(x);
+            }
+            catch (const std::runtime_error&) {
+                ++thrown;
+            }
+            try {
+                v.emplace_back(unexpect, e);
+            }
+            catch (const std::runtime_error&) {
+                ++thrown;
+            }
+            throws_on_copy::armed = false;
+            CCAT_CHECK(thrown == 2 && v.size() == n && v.count_errors() == n / 2);
+
+            std::size_t values = 0;
+            for (auto it = v.values().begin(); it != v.values().end(); ++it) {
+                CCAT_CHECK(it.index() % 2 == 0 && *it == static_cast<int>(it.index()));
+                ++values;
+            }
+            CCAT_CHECK(values == n - n / 2);
+
+            v.push_back(7);
+            v.emplace_back(unexpect, 8);
+            CCAT_CHECK(v.size() == n + 2 && v.has_value(n) && v.value(n) == 7 && !v.has_value(n + 1) && v.error(n + 1).id == 8);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/// @author: ccat
+
+/// @brief: `views::values` and `views::errors` over a range whose elements are references, which they refer into, and over
+/// one that generates its elements, such as `std::views::transform`, whose parts they must return by value, generating
+/// each element once; `views::and_then` calls its function once per element dereferenced
+
+#include "expected_views.hpp"
+#include "check.hpp"
+#include <string>
+#include <vector>
+
+namespace {
+
+using ccat::expected;
+using ccat::unexpect;
+
+using result = expected<std::string, std::string>;
+
+/// @brief: long enough to live on the heap, so that a reference into a destroyed temporary reads freed memory
+auto make(int i) ->result {
+    if (i % 3 == 0) return result(unexpect, "the error of element " + std::to_string(i) + ", which is not a short string");
+    return "the value of element " + std::to_string(i) + ", which is not a short string";
+}
+
+#if defined(CCAT_EXPECTED_HAS_RANGES)
+int generated_count = 0;
+
+auto make_counted(int i) ->result {
+    ++generated_count;
+    return make(i);
+}
+#endif
+
+}
+
+auto main() ->int {
+    std::vector<result> stored;
+    for (int i = 0; i < 9; ++i) stored.push_back(make(i));
+
+    auto values = stored | ccat::views::values;
+    static_assert(std::is_same_v<decltype(*values.begin()), std::string&>, "the values of stored elements must be references");
+    std::vector<std::string> seen;
+    for (auto& v : values) seen.push_back(v);
+    CCAT_CHECK(seen.size() == 6 && seen[0] == *stored[1] && &*values.begin() == &*stored[1]);
+
+#if defined(CCAT_EXPECTED_HAS_RANGES)
+    const int indices[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    auto generated = indices | std::views::transform(make);
+
+    auto generated_values = generated | ccat::views::values;
+    static_assert(std::is_same_v<decltype(*generated_values.begin()), std::string>, "the values of generated elements must be copies");
+    seen.clear();
+    for (const auto& v : generated_values) seen.push_back(v);
+    CCAT_CHECK(seen.size() == 6);
+    for (std::size_t i = 0; i < seen.size(); ++i) CCAT_CHECK(seen[i] == *stored[i / 2 * 3 + i % 2 + 1]);
+
+    auto generated_errors = generated | ccat::views::errors;
+    static_assert(std::is_same_v<decltype(*generated_errors.begin()), std::string>, "the errors of generated elements must be copies");
+    seen.clear();
+    for (const auto& e : generated_errors) seen.push_back(e);
+    CCAT_CHECK(seen.size() == 3 && seen[0] == stored[0].error() && seen[1] == stored[3].error() && seen[2] == stored[6].error());
+
+    seen.clear();
+    for (auto&& v : generated | ccat::views::take_while_ok) seen.push_back(v);
+    CCAT_CHECK(seen.empty());
+
+    /// @note: skipping, ending and dereferencing an element all look at the one generated for it
+    auto counted = indices | std::views::transform(make_counted);
+    seen.clear();
+    for (const auto& v : counted | ccat::views::values) seen.push_back(v);
+    CCAT_CHECK(seen.size() == 6 && generated_count == 9);
+    generated_count = 0;
+    seen.clear();
+    for (const auto& e : counted | ccat::views::errors) seen.push_back(e);
+    CCAT_CHECK(seen.size() == 3 && generated_count == 9);
+    generated_count = 0;
+    for (auto&& v : indices | std::views::drop(1) | std::views::take(2) | std::views::transform(make_counted) | ccat::views::take_while_ok) seen.push_back(v);
+    CCAT_CHECK(seen.size() == 5 && seen[3] == *stored[1] && seen[4] == *stored[2] && generated_count == 2);
+
+    /// @note: a second dereference of the same position generates the element again rather than reading a moved-from one
+    generated_count = 0;
+    auto again = (counted | ccat::views::values).begin();
+    const std::string first = *again;
+    CCAT_CHECK(first == *stored[1] && *again == first && generated_count == 3);
+#endif
+
+    /// @note: `and_then` is lazy: its function runs when an element is dereferenced, and only for the values
+    int calls = 0;
+    auto lengths = stored | ccat::views::and_then([&calls](const std::string& v) {
+        ++calls;
+        return expected<std::size_t, std::string>(v.size());
+    });
+    CCAT_CHECK(calls == 0);
+    std::vector<expected<std::size_t, std::string>> chained;
+    for (auto&& x : lengths) chained.push_back(x);
+    CCAT_CHECK(chained.size() == 9 && calls == 6);
+    for (std::size_t i = 0; i < chained.size(); ++i) {
+        if (i % 3 == 0) CCAT_CHECK(!chained[i].has_value() && chained[i].error() == stored[i].error());
+        else CCAT_CHECK(chained[i].has_value() && *chained[i] == stored[i]->size());
+    }
+#if defined(CCAT_EXPECTED_HAS_RANGES)
+    /// @note: over generated elements the function gets the value as an rvalue, and composes with the other views
+    generated_count = 0;
+    calls = 0;
+    auto moved = indices | std::views::transform(make_counted) | ccat::views::and_then([&calls](std::string&& v) {
+        ++calls;
+        return expected<std::string, std::string>(std::move(v) + "!");
+    }) | ccat::views::values;
+    seen.clear();
+    for (auto&& v : moved) seen.push_back(v);
+    CCAT_CHECK(seen.size() == 6 && seen[0] == *stored[1] + "!" && calls == 6 && generated_count == 9);
+#endif
+}